@@ -0,0 +1,268 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   arith.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/17 14:12:56 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/17 14:12:56 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static long long	parse_expr(t_arith *a, int min_prec);
+
+static void	skip_blanks(t_arith *a)
+{
+	while (a->s[a->pos] && ft_strchr(" \t\n", a->s[a->pos]))
+		a->pos++;
+}
+
+static long long	to_number(char *value)
+{
+	long long	n;
+	int			i;
+	int			neg;
+
+	i = 0;
+	while (value[i] == ' ')
+		i++;
+	neg = (value[i] == '-');
+	i += (value[i] == '-' || value[i] == '+');
+	n = 0;
+	while (value[i] >= '0' && value[i] <= '9')
+		n = n * 10 + (value[i++] - '0');
+	if (neg)
+		return (-n);
+	return (n);
+}
+
+// Variables are looked up in place: the name is compared straight
+// from the expression text, nothing is copied
+static long long	variable(t_arith *a)
+{
+	t_env_list	*env;
+	char		name[2];
+	char		*param;
+	long long	value;
+	int			len;
+
+	if (a->s[a->pos] == '$')
+		a->pos++;
+	if ((a->s[a->pos] >= '0' && a->s[a->pos] <= '9') || a->s[a->pos] == '#')
+	{
+		name[0] = a->s[a->pos++];
+		name[1] = '\0';
+		param = positional(name);
+		value = to_number(param);
+		free(param);
+		return (value);
+	}
+	len = 0;
+	while (ft_isalnum(a->s[a->pos + len]))
+		len++;
+	env = *g_shell.env_list;
+	while (env && (ft_strncmp(env->name, a->s + a->pos, len)
+			|| env->name[len]))
+		env = env->next;
+	a->pos += len;
+	if (!len || !env || !env->value)
+		return (0);
+	return (to_number(env->value));
+}
+
+static long long	number(t_arith *a)
+{
+	unsigned long long	value;
+	int					base;
+	int					digit;
+
+	value = 0;
+	base = 10;
+	if (a->s[a->pos] == '0' && (a->s[a->pos + 1] == 'x'
+			|| a->s[a->pos + 1] == 'X'))
+	{
+		base = 16;
+		a->pos += 2;
+	}
+	while (1)
+	{
+		digit = a->s[a->pos];
+		if (digit >= '0' && digit <= '9')
+			digit -= '0';
+		else if (base == 16 && (digit | 32) >= 'a' && (digit | 32) <= 'f')
+			digit = (digit | 32) - 'a' + 10;
+		else
+			break ;
+		value = value * base + digit;
+		a->pos++;
+	}
+	return ((long long)value);
+}
+
+static long long	parse_unary(t_arith *a)
+{
+	long long	value;
+	char		c;
+
+	skip_blanks(a);
+	c = a->s[a->pos];
+	if (c == '(')
+	{
+		a->pos++;
+		value = parse_expr(a, 0);
+		skip_blanks(a);
+		if (a->s[a->pos] != ')')
+			a->err = "missing ')'";
+		a->pos++;
+		return (value);
+	}
+	if (c == '-' || c == '+' || c == '!' || c == '~')
+	{
+		a->pos++;
+		value = parse_unary(a);
+		if (c == '-')
+			return ((long long)(0ULL - (unsigned long long)value));
+		if (c == '!')
+			return (!value);
+		if (c == '~')
+			return (~value);
+		return (value);
+	}
+	if (c >= '0' && c <= '9')
+		return (number(a));
+	if (c == '$' || ft_isalnum(c))
+		return (variable(a));
+	a->err = "syntax error in expression";
+	return (0);
+}
+
+// Binding power of the operator at pos (0 when there is none);
+// *len receives its length
+static int	binary_op(t_arith *a, int *op, int *len)
+{
+	static char	*ops[] = {"||", "&&", "==", "!=", "<=", ">=", "<", ">",
+		"+", "-", "*", "/", "%", NULL};
+	static int	prec[] = {1, 2, 3, 3, 4, 4, 4, 4, 5, 5, 6, 6, 6};
+	int			i;
+
+	skip_blanks(a);
+	i = 0;
+	while (ops[i])
+	{
+		*len = ft_strlen(ops[i]);
+		if (!ft_strncmp(a->s + a->pos, ops[i], *len))
+		{
+			*op = i;
+			return (prec[i]);
+		}
+		i++;
+	}
+	return (0);
+}
+
+static long long	apply(t_arith *a, int op, long long l, long long r)
+{
+	unsigned long long	ul;
+	unsigned long long	ur;
+
+	ul = (unsigned long long)l;
+	ur = (unsigned long long)r;
+	if (a->skip)
+		return (0);
+	if (op >= 11 && r == 0)
+	{
+		a->err = "division by 0";
+		return (0);
+	}
+	if (op >= 11 && r == -1)
+		return ((long long)(0ULL - ul) * (op == 11));
+	if (op == 0 || op == 1)
+		return ((op == 0 && (l || r)) || (op == 1 && l && r));
+	if (op == 2 || op == 3)
+		return ((l == r) == (op == 2));
+	if (op == 4 || op == 5)
+		return ((op == 4 && l <= r) || (op == 5 && l >= r));
+	if (op == 6 || op == 7)
+		return ((op == 6 && l < r) || (op == 7 && l > r));
+	if (op == 8)
+		return ((long long)(ul + ur));
+	if (op == 9)
+		return ((long long)(ul - ur));
+	if (op == 10)
+		return ((long long)(ul * ur));
+	if (op == 11)
+		return (l / r);
+	return (l % r);
+}
+
+// Pratt loop: operators binding tighter than min_prec are folded
+// into the left operand. The right side of a decided && or || is
+// still parsed, but with skip set nothing in it is evaluated
+static long long	parse_expr(t_arith *a, int min_prec)
+{
+	long long	lhs;
+	long long	rhs;
+	int			op;
+	int			len;
+	int			prec;
+	int			skip;
+
+	lhs = parse_unary(a);
+	while (!a->err)
+	{
+		prec = binary_op(a, &op, &len);
+		if (!prec || prec < min_prec)
+			break ;
+		a->pos += len;
+		skip = ((op == 0 && lhs) || (op == 1 && !lhs));
+		a->skip += skip;
+		rhs = parse_expr(a, prec + 1);
+		a->skip -= skip;
+		lhs = apply(a, op, lhs, rhs);
+	}
+	return (lhs);
+}
+
+// $((expr)) over 64-bit integers; only the resulting string is allocated
+char	*arith_expand(char *expr)
+{
+	t_arith				a;
+	char				buf[24];
+	unsigned long long	n;
+	long long			value;
+	int					i;
+
+	a.s = expr;
+	a.pos = 0;
+	a.skip = 0;
+	a.err = NULL;
+	value = parse_expr(&a, 0);
+	skip_blanks(&a);
+	if (!a.err && a.s[a.pos])
+		a.err = "syntax error in expression";
+	if (a.err)
+	{
+		write(2, "minishell: ", 11);
+		write(2, a.err, ft_strlen(a.err));
+		write(2, "\n", 1);
+		g_shell.status = 1;
+		return (ft_strdup(""));
+	}
+	i = 23;
+	buf[i] = '\0';
+	n = (unsigned long long)value;
+	if (value < 0)
+		n = 0ULL - n;
+	buf[--i] = '0' + n % 10;
+	while (n / 10 && i > 1)
+	{
+		n /= 10;
+		buf[--i] = '0' + n % 10;
+	}
+	if (value < 0)
+		buf[--i] = '-';
+	return (ft_strdup(buf + i));
+}
@@ -0,0 +1,58 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   buffer.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/17 09:48:20 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/17 09:48:20 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+// Makes room for at least extra more bytes plus the terminating '\0'
+void	buf_grow(t_buf *buf, size_t extra)
+{
+	char	*new;
+	size_t	cap;
+
+	if (buf->len + extra + 1 <= buf->cap)
+		return ;
+	cap = buf->cap * 2;
+	if (cap < buf->len + extra + 1)
+		cap = buf->len + extra + 1;
+	if (cap < 256)
+		cap = 256;
+	new = malloc(cap);
+	if (buf->data)
+		memcpy(new, buf->data, buf->len);
+	free(buf->data);
+	buf->data = new;
+	buf->cap = cap;
+}
+
+void	buf_append(t_buf *buf, char *data, size_t len)
+{
+	buf_grow(buf, len);
+	memcpy(buf->data + buf->len, data, len);
+	buf->len += len;
+	buf->data[buf->len] = '\0';
+}
+
+// Reads fd until EOF straight into the spare capacity of buf
+void	buf_read_fd(t_buf *buf, int fd)
+{
+	ssize_t	n;
+
+	while (1)
+	{
+		buf_grow(buf, 4096);
+		n = read(fd, buf->data + buf->len, buf->cap - buf->len - 1);
+		if (n <= 0)
+			break ;
+		buf->len += n;
+	}
+	buf->data[buf->len] = '\0';
+}
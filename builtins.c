@@ -47,8 +47,7 @@ void    ft_pwd(void)
    else
    {
 	   perror("getcwd() error");
-      exit(1);
+      return ;
     }
 	ft_putstr("\n");
-    exit(0);
 }
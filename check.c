@@ -0,0 +1,188 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   check.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/07 11:20:45 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/07 11:20:45 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <errno.h>
+
+// Same as read_command: an open loop or function takes the next lines
+// until it closes or the script ends
+static void	check_command(t_script *s, char *line)
+{
+	t_node	*tree;
+	char	*err;
+	int		state;
+
+	tree = script_command(s, line, &state, &err);
+	script_report(s, state, err);
+	script_heredocs(s, tree);
+	free_tree(tree);
+}
+
+static void	check_file(t_check *c, int i)
+{
+	t_script	s;
+	t_buf		data;
+	struct stat	st;
+	char		msg[128];
+	char		*line;
+	int			fd;
+
+	s.path = c->files[i];
+	s.out = &c->out[i];
+	s.line = 0;
+	fd = open(s.path, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0 && !fstat(fd, &st) && S_ISDIR(st.st_mode))
+	{
+		close(fd);
+		fd = -1;
+		errno = EISDIR;
+	}
+	if (fd < 0)
+	{
+		script_error(&s, strerror_r(errno, msg, sizeof(msg)));
+		return ;
+	}
+	memset(&data, 0, sizeof(t_buf));
+	buf_read_fd(&data, fd);
+	close(fd);
+	s.pos = data.data;
+	s.end = data.data + data.len;
+	line = script_line(&s);
+	while (line)
+	{
+		check_command(&s, line);
+		line = script_line(&s);
+	}
+	free(data.data);
+}
+
+// A worker takes its own files from the bottom of its deque; once it
+// is empty it steals from the top of the others', so a worker stuck on
+// a few long scripts does not hold back the rest of its share
+static int	take_file(t_check *c, int id)
+{
+	t_deque	*q;
+	int		file;
+	int		i;
+
+	file = -1;
+	q = &c->queues[id];
+	pthread_mutex_lock(&q->lock);
+	if (q->bottom > q->top)
+		file = q->items[--q->bottom];
+	pthread_mutex_unlock(&q->lock);
+	i = 1;
+	while (file < 0 && i < c->nthreads)
+	{
+		q = &c->queues[(id + i++) % c->nthreads];
+		pthread_mutex_lock(&q->lock);
+		if (q->bottom > q->top)
+			file = q->items[q->top++];
+		pthread_mutex_unlock(&q->lock);
+	}
+	return (file);
+}
+
+static void	*check_worker(void *arg)
+{
+	t_worker	*w;
+	int			file;
+
+	w = arg;
+	file = take_file(w->check, w->id);
+	while (file >= 0)
+	{
+		check_file(w->check, file);
+		file = take_file(w->check, w->id);
+	}
+	return (NULL);
+}
+
+// Files are dealt out in contiguous runs, one deque per online CPU
+static void	check_init(t_check *c, char **files, int n, int *items)
+{
+	int	i;
+
+	c->files = files;
+	c->out = malloc(sizeof(t_buf) * (n + 1));
+	memset(c->out, 0, sizeof(t_buf) * (n + 1));
+	c->nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (c->nthreads > n)
+		c->nthreads = n;
+	if (c->nthreads < 1)
+		c->nthreads = 1;
+	c->queues = malloc(sizeof(t_deque) * c->nthreads);
+	i = 0;
+	while (i < n)
+	{
+		items[i] = i;
+		i++;
+	}
+	i = 0;
+	while (i < c->nthreads)
+	{
+		pthread_mutex_init(&c->queues[i].lock, NULL);
+		c->queues[i].items = items + (long)n * i / c->nthreads;
+		c->queues[i].top = 0;
+		c->queues[i].bottom = (long)n * (i + 1) / c->nthreads
+			- (long)n * i / c->nthreads;
+		i++;
+	}
+}
+
+// minishell --check FILE...: syntax-checks every script without running
+// anything and prints "file:line: message" per error, in argument order
+int	check_files(char **files)
+{
+	t_check		c;
+	t_worker	*workers;
+	int			*items;
+	int			status;
+	int			n;
+	int			i;
+
+	n = 0;
+	while (files[n])
+		n++;
+	items = malloc(sizeof(int) * (n + 1));
+	check_init(&c, files, n, items);
+	workers = malloc(sizeof(t_worker) * c.nthreads);
+	i = -1;
+	while (++i < c.nthreads)
+	{
+		workers[i].check = &c;
+		workers[i].id = i;
+		if (i && pthread_create(&workers[i].tid, NULL, check_worker,
+				&workers[i]))
+			workers[i].id = -1;
+	}
+	check_worker(&workers[0]);
+	status = 0;
+	i = 0;
+	while (++i < c.nthreads)
+		if (workers[i].id >= 0)
+			pthread_join(workers[i].tid, NULL);
+	i = -1;
+	while (++i < n)
+	{
+		if (c.out[i].len)
+			status = 1;
+		write(1, c.out[i].data, c.out[i].len);
+		free(c.out[i].data);
+	}
+	free(c.out);
+	free(c.queues);
+	free(workers);
+	free(items);
+	return (status);
+}
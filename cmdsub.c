@@ -0,0 +1,75 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cmdsub.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/17 10:31:05 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/17 10:31:05 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static void	capture_child(t_cmd_line *cmd, t_node *tree, t_buf *buf)
+{
+	int		fd[2];
+	pid_t	pid;
+	int		status;
+
+	if (pipe_cloexec(fd) == -1)
+		return ;
+	pid = fork();
+	if (!pid)
+	{
+		dup2(fd[1], 1);
+		close(fd[0]);
+		close(fd[1]);
+		g_shell.capture = NULL;
+		g_shell.last_line = 1;
+		if (cmd)
+			execution(&cmd, g_shell.env_list, g_shell.export_list);
+		else
+			run_list(tree);
+		exit(g_shell.status);
+	}
+	close(fd[1]);
+	buf_read_fd(buf, fd[0]);
+	close(fd[0]);
+	if (pid > 0 && waitpid(pid, &status, 0) > 0)
+		g_shell.status = exit_code(status);
+}
+
+// $(cmd) and `cmd`: the output, minus trailing newlines. A single
+// pipeline is expanded here so a lone output builtin never forks.
+char	*cmdsub_capture(char *line)
+{
+	t_node		*tree;
+	t_cmd_line	*cmd;
+	t_buf		buf;
+	int			state;
+
+	memset(&buf, 0, sizeof(t_buf));
+	buf_grow(&buf, 0);
+	buf.data[0] = '\0';
+	tree = parse_input(line, &state);
+	if (tree && !tree->next && tree->type == N_PIPELINE)
+	{
+		cmd = build_pipeline(tree->tokens);
+		if (cmd && !cmd->next && runs_as_stage(cmd))
+		{
+			capture_stage(cmd->str, &buf);
+			g_shell.status = 0;
+		}
+		else if (cmd)
+			capture_child(cmd, NULL, &buf);
+		procsub_cleanup();
+	}
+	else if (tree)
+		capture_child(NULL, tree, &buf);
+	free_tree(tree);
+	while (buf.len && buf.data[buf.len - 1] == '\n')
+		buf.data[--buf.len] = '\0';
+	return (buf.data);
+}
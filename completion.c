@@ -0,0 +1,205 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   completion.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/15 15:03:44 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/15 15:03:44 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static t_completion	*get_completion(void)
+{
+	static t_completion	comp;
+
+	return (&comp);
+}
+
+static void	load_dir(t_completion *comp, t_path_dir *dir)
+{
+	DIR				*d;
+	struct dirent	*entry;
+	t_args			names;
+
+	args_init(&names);
+	d = opendir(dir->path);
+	entry = NULL;
+	if (d)
+		entry = readdir(d);
+	while (entry)
+	{
+		if (entry->d_name[0] != '.' && entry->d_type != DT_DIR
+			&& !faccessat(dirfd(d), entry->d_name, X_OK, 0))
+		{
+			args_push(&names, ft_strdup(entry->d_name));
+			trie_insert(&comp->root, entry->d_name);
+		}
+		entry = readdir(d);
+	}
+	if (d)
+		closedir(d);
+	dir->names = names.str;
+}
+
+static void	unload_dir(t_completion *comp, t_path_dir *dir)
+{
+	int	i;
+
+	i = 0;
+	while (dir->names && dir->names[i])
+	{
+		trie_remove(&comp->root, dir->names[i]);
+		free(dir->names[i++]);
+	}
+	free(dir->names);
+	dir->names = NULL;
+}
+
+// Only directories whose mtime moved since the last TAB are rescanned
+static void	refresh_dir(t_completion *comp, char *path)
+{
+	t_path_dir	*dir;
+	struct stat	st;
+
+	if (stat(path, &st) == -1)
+		return ;
+	dir = comp->dirs;
+	while (dir && ft_strcmp(dir->path, path))
+		dir = dir->next;
+	if (dir && dir->seen)
+		return ;
+	if (!dir)
+	{
+		dir = malloc(sizeof(t_path_dir));
+		memset(dir, 0, sizeof(t_path_dir));
+		dir->path = ft_strdup(path);
+		dir->next = comp->dirs;
+		comp->dirs = dir;
+	}
+	else if (dir->mtime.tv_sec == st.st_mtim.tv_sec
+		&& dir->mtime.tv_nsec == st.st_mtim.tv_nsec)
+	{
+		dir->seen = 1;
+		return ;
+	}
+	unload_dir(comp, dir);
+	dir->mtime = st.st_mtim;
+	dir->seen = 1;
+	load_dir(comp, dir);
+}
+
+void	refresh_path_trie(t_completion *comp)
+{
+	t_path_dir	**link;
+	t_path_dir	*dir;
+	char		**path;
+	int			i;
+
+	path = get_path(comp->env_list);
+	i = 0;
+	while (path && path[i])
+		refresh_dir(comp, path[i++]);
+	if (path)
+		free_2d(path);
+	link = &comp->dirs;
+	while (*link)
+	{
+		dir = *link;
+		if (!dir->seen)
+		{
+			unload_dir(comp, dir);
+			*link = dir->next;
+			free(dir->path);
+			free(dir);
+			continue ;
+		}
+		dir->seen = 0;
+		link = &dir->next;
+	}
+}
+
+static char	*next_match(const char *text, int state)
+{
+	t_completion	*comp;
+
+	(void)text;
+	comp = get_completion();
+	if (!state)
+		comp->index = 0;
+	if (!comp->matches || !comp->matches[comp->index])
+	{
+		if (comp->matches)
+			free(comp->matches);
+		comp->matches = NULL;
+		return (NULL);
+	}
+	return (comp->matches[comp->index++]);
+}
+
+static void	collect_vars(t_completion *comp, const char *text)
+{
+	t_env_list	*env;
+	t_args		out;
+	int			len;
+
+	args_init(&out);
+	len = ft_strlen((char *)text);
+	env = *comp->env_list;
+	while (env)
+	{
+		if (!ft_strncmp(env->name, text, len))
+			args_push(&out, ft_strdup(env->name));
+		env = env->next;
+	}
+	comp->matches = out.str;
+}
+
+static int	command_position(int start)
+{
+	int	i;
+
+	i = start - 1;
+	while (i >= 0 && ft_strchr(" \t", rl_line_buffer[i]))
+		i--;
+	return (i < 0 || ft_strchr("|;(", rl_line_buffer[i]) != NULL);
+}
+
+static char	**ms_completion(const char *text, int start, int end)
+{
+	t_completion	*comp;
+
+	(void)end;
+	comp = get_completion();
+	free(comp->matches);
+	comp->matches = NULL;
+	if (start > 0 && rl_line_buffer[start - 1] == '$')
+		collect_vars(comp, text);
+	else if (command_position(start) && !ft_strchr((char *)text, '/'))
+	{
+		refresh_path_trie(comp);
+		comp->matches = trie_collect(&comp->root, (char *)text);
+	}
+	else
+		return (NULL);
+	return (rl_completion_matches(text, next_match));
+}
+
+void	init_completion(t_env_list **env_list)
+{
+	t_completion	*comp;
+	static char		*names[] = {"cd", "echo", "env", "export", "pwd",
+		"unset", "exit", "exec", "test", "break", "continue", "cat",
+		"parallel", "source", "read", "fanout", NULL};
+	int				i;
+
+	comp = get_completion();
+	comp->env_list = env_list;
+	i = 0;
+	while (names[i])
+		trie_insert(&comp->root, names[i++]);
+	rl_attempted_completion_function = ms_completion;
+}
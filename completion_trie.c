@@ -0,0 +1,123 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   completion_trie.c                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/15 14:21:08 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/15 14:21:08 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+// Children are kept sorted so completions come out in order
+static t_trie	**trie_slot(t_trie **link, char c)
+{
+	while (*link && (*link)->c < c)
+		link = &(*link)->next;
+	return (link);
+}
+
+static void	trie_free(t_trie *node)
+{
+	t_trie	*next;
+
+	while (node)
+	{
+		next = node->next;
+		trie_free(node->child);
+		free(node);
+		node = next;
+	}
+}
+
+// The same name may come from several PATH directories, so terminals
+// are reference counted and a branch is freed once its count drops to 0
+void	trie_insert(t_trie *root, char *s)
+{
+	t_trie	**slot;
+	t_trie	*node;
+
+	root->count++;
+	while (*s)
+	{
+		slot = trie_slot(&root->child, *s);
+		if (!*slot || (*slot)->c != *s)
+		{
+			node = malloc(sizeof(t_trie));
+			memset(node, 0, sizeof(t_trie));
+			node->c = *s;
+			node->next = *slot;
+			*slot = node;
+		}
+		root = *slot;
+		root->count++;
+		s++;
+	}
+	root->end++;
+}
+
+void	trie_remove(t_trie *root, char *s)
+{
+	t_trie	**slot;
+	t_trie	*node;
+
+	root->count--;
+	while (*s)
+	{
+		slot = trie_slot(&root->child, *s);
+		node = *slot;
+		if (!node || node->c != *s)
+			return ;
+		if (--node->count == 0)
+		{
+			*slot = node->next;
+			node->next = NULL;
+			trie_free(node);
+			return ;
+		}
+		root = node;
+		s++;
+	}
+	root->end--;
+}
+
+static void	collect(t_trie *node, char *buf, int len, t_args *out)
+{
+	while (node && len < 1023)
+	{
+		buf[len] = node->c;
+		buf[len + 1] = '\0';
+		if (node->end)
+			args_push(out, ft_strdup(buf));
+		collect(node->child, buf, len + 1, out);
+		node = node->next;
+	}
+}
+
+// Walks down to the prefix node and only visits the subtree below it
+char	**trie_collect(t_trie *root, char *prefix)
+{
+	t_args	out;
+	char	buf[1024];
+	int		len;
+
+	args_init(&out);
+	len = 0;
+	while (prefix[len] && root)
+	{
+		root = *trie_slot(&root->child, prefix[len]);
+		if (!root || root->c != prefix[len])
+			return (out.str);
+		buf[len++] = root->c;
+		if (len == 1023)
+			return (out.str);
+	}
+	buf[len] = '\0';
+	if (len && root->end)
+		args_push(&out, ft_strdup(buf));
+	collect(root->child, buf, len, &out);
+	return (out.str);
+}
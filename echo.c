@@ -27,10 +27,9 @@ int is_n(char *str)
     int i;
 
     i = 0;
-    if(str == NULL)
+    if(str == NULL || str[0] != '-' || str[1] != 'n')
         return 0;
-    if (str[i] == '-')
-        i++;
+    i++;
     while (str[i] && str[i] != 32)
     {
         if (str[i] != 'n')
@@ -12,6 +12,25 @@
 
 #include "minishell.h"
 
+static char	*stage_name(t_cmd_line *cmd, int i)
+{
+	while (i-- > 0 && cmd)
+		cmd = cmd->next;
+	if (!cmd || !cmd->str[0])
+		return ("");
+	return (cmd->str[0]);
+}
+
+static int	has_heredoc(t_cmd_line *cmd)
+{
+	t_redirections	*red;
+
+	red = cmd->redirections;
+	while (red && red->type != HEREDOC)
+		red = red->next;
+	return (red != NULL);
+}
+
 void execute_command(t_cmd_line **cmd_line, t_env_list **env_list, int **fd, t_export **export)
 {
 	t_cmd_line *cmd_tmp = *cmd_line;
@@ -20,21 +39,47 @@ void execute_command(t_cmd_line **cmd_line, t_env_list **env_list, int **fd, t_e
 	t_redirections	*l_outfile;
 	int i = 0;
 	int flg = 0;
-	pid_t	pid;
+	pid_t	*pids;
 	int	heredoc_fd;
+	int	status;
+	long	start;
+	pids = malloc(sizeof(pid_t) * count_list(cmd_line));
+	tune_pipeline();
 	while (cmd_tmp)
 	{
+		start = trace_now();
 		if (cmd_tmp->separator == e_pipe)
 		{
-			pipe(fd[i]);
+			pipe_cloexec(fd[i]);
+			tune_pipe(fd[i]);
 			flg = 1;
+			trace_span("pipe", start);
+			start = trace_now();
 		}
 		ft_heredoc(&cmd_tmp, &heredoc_fd);
-		if (!(pid = fork()))
+		if (has_heredoc(cmd_tmp))
+			trace_span("heredoc", start);
+		if (cmd_tmp->next && runs_as_stage(cmd_tmp))
+		{
+			run_stage(cmd_tmp, fd[i][1]);
+			pids[i] = -1;
+		}
+		else if (!cmd_tmp->next && can_tail_exec(cmd_tmp))
+			pids[i] = 0;
+		else
+		{
+			start = trace_now();
+			pids[i] = fork();
+			trace_fork(pids[i], stage_name(cmd_tmp, 0), start);
+		}
+		if (!pids[i])
 		{
+			close_stage_fds();
+			if (flg)
+				tune_stage(i);
 			l_infile = last_infile(&cmd_tmp, &no_file);
 			if (!no_file)
-				return ;
+				exit(1);
 			l_outfile = last_outfile(&cmd_tmp);
 			if (flg)
 				dup_to_pipe(fd, i, count_list(cmd_line));
@@ -48,12 +93,32 @@ void execute_command(t_cmd_line **cmd_line, t_env_list **env_list, int **fd, t_e
 		cmd_tmp = cmd_tmp->next;
 		i++;
 	}
-	while (wait(0) != -1);
+	// only our own stages: process substitutions are reaped separately
+	i = -1;
+	while (++i < count_list(cmd_line))
+	{
+		if (pids[i] > 0 && wait_stage(pids[i], &status, stage_name(*cmd_line, i)) > 0
+			&& i + 1 == count_list(cmd_line))
+			g_shell.status = exit_code(status);
+	}
+	wait_stages();
+	free(pids);
 }
 
 void execution(t_cmd_line **cmd_line, t_env_list **env_list,t_export **export_list)
 {
-	if ((*cmd_line) && main_builtins(cmd_line) && (*cmd_line)->separator == e_nline) // main process // cd / unset / exit / export with variables
+	if ((*cmd_line) && (*cmd_line)->separator == e_nline
+		&& !(*cmd_line)->str[0] && (*cmd_line)->assigns
+		&& (*cmd_line)->assigns[0])
+	{
+		set_assignments((*cmd_line)->assigns);
+		if (!(*cmd_line)->redirections)
+			return ;
+	}
+	if ((*cmd_line) && (*cmd_line)->separator == e_nline
+		&& find_function((*cmd_line)->str[0]))
+		run_function(cmd_line);
+	else if ((*cmd_line) && main_builtins(cmd_line) && (*cmd_line)->separator == e_nline) // main process // cd / unset / exit / export with variables
 	{
 		int	fd;
 		ft_heredoc(cmd_line, &fd);
@@ -23,43 +23,77 @@ int	builtins(char	*cmd)
 		return (3);
 	if (!ft_strcmp(cmd, "env"))
 		return (4);
+	if (!ft_strcmp(cmd, "test") || !ft_strcmp(cmd, "["))
+		return (5);
+	if (!ft_strcmp(cmd, "break") || !ft_strcmp(cmd, "continue"))
+		return (6);
+	if (!ft_strcmp(cmd, "cat"))
+		return (7);
+	if (!ft_strcmp(cmd, "parallel"))
+		return (8);
+	if (!ft_strcmp(cmd, "source") || !ft_strcmp(cmd, "."))
+		return (9);
+	if (!ft_strcmp(cmd, "read"))
+		return (10);
+	if (!ft_strcmp(cmd, "fanout"))
+		return (11);
 	return (0);
 }
+
+// Same as builtins() but looks at the arguments too: a cat given
+// options is not ours to run
+int	builtin_code(char **str)
+{
+	int	code;
+
+	code = builtins(str[0]);
+	if (code == 7 && cat_options(str))
+		return (0);
+	return (code);
+}
+
 void    print_env(t_env_list *list)
 {
     t_env_list *head = list;
     while (head)
     {
-        if(ft_strcmp(head->value,"") == 0)
-            printf("%s\n",head->name);
-        else
-            printf("%s=\"%s\"\n",head->name,head->value);
-            head = head->next;
+        ft_putstr(head->name);
+        if(ft_strcmp(head->value,"") != 0)
+        {
+            ft_putstr("=\"");
+            ft_putstr(head->value);
+            ft_putstr("\"");
+        }
+        ft_putstr("\n");
+        head = head->next;
      }
 }
 void	exec_builtins(char	**str, t_env_list **env_list, int code, t_export **export)
 {
-    if (code == 1)
-    {
-        ft_echo(str);
-        exit(0);
-    }
-	if (code == 2)
-    {
-		ft_pwd();
-        exit(0);
-    }
-	else if (code == 3)
+    t_buf   buf;
+
+    if (code >= 1 && code <= 4)
     {
-        do_export(str,export,env_list);
+        memset(&buf, 0, sizeof(t_buf));
+        capture_stage(str, &buf);
+        if (buf.len)
+            write(1, buf.data, buf.len);
         exit(0);
     }
-    else if(code == 4)
-    {
-        print_env(*env_list);
-      
+    else if (code == 5)
+        exit(ft_test(str));
+    else if (code == 6)
         exit(0);
-    }
+    else if (code == 7)
+        exit(ft_cat(str));
+    else if (code == 8)
+        exit(ft_parallel(str));
+    else if (code == 9)
+        exit(ft_source(str));
+    else if (code == 10)
+        exit(ft_read(str));
+    else if (code == 11)
+        exit(ft_fanout(str));
 
 }
 
@@ -73,6 +107,12 @@ int main_builtins(t_cmd_line **cmd_line)
             return (1);
         if (!ft_strcmp((*cmd_line)->str[0], "unset"))
             return (1);
+        if (!ft_strcmp((*cmd_line)->str[0], "exec"))
+            return (!g_shell.embedded);
+        if (builtin_code((*cmd_line)->str) == 7)
+            return ((*cmd_line)->str[1] || !g_shell.interactive);
+        if (builtin_code((*cmd_line)->str) >= 5)
+            return (1);
     }
     return (0);
 }
@@ -85,4 +125,71 @@ void    execute_builtins(t_cmd_line **cmd_line, t_env_list **env_list,t_export *
        do_export((*cmd_line)->str,export_list,env_list);
     if (!ft_strcmp((*cmd_line)->str[0], "unset"))
         do_unset((*cmd_line)->str,export_list,env_list);
-}
\ No newline at end of file
+    if (!ft_strcmp((*cmd_line)->str[0], "exec"))
+        ft_exec(cmd_line, env_list);
+    if (builtins((*cmd_line)->str[0]) == 5)
+        g_shell.status = ft_test((*cmd_line)->str);
+    if (builtins((*cmd_line)->str[0]) == 6)
+        g_shell.status = ft_break((*cmd_line)->str);
+    if (builtins((*cmd_line)->str[0]) == 7)
+        run_redirected(cmd_line, ft_cat);
+    if (builtins((*cmd_line)->str[0]) == 8)
+        run_redirected(cmd_line, ft_parallel);
+    if (builtins((*cmd_line)->str[0]) == 9)
+        run_redirected(cmd_line, ft_source);
+    if (builtins((*cmd_line)->str[0]) == 10)
+        run_redirected(cmd_line, ft_read);
+    if (builtins((*cmd_line)->str[0]) == 11)
+        run_redirected(cmd_line, ft_fanout);
+}
+
+// Without a command the redirections stay applied to the shell itself
+void    ft_exec(t_cmd_line **cmd_line, t_env_list **env_list)
+{
+    t_redirections  *l_infile;
+    t_redirections  *l_outfile;
+    int             no_file;
+
+    no_file = 1;
+    l_infile = last_infile(cmd_line, &no_file);
+    if (!no_file)
+    {
+        g_shell.status = 1;
+        return ;
+    }
+    l_outfile = last_outfile(cmd_line);
+    if (l_outfile)
+        dup_outfile(l_outfile);
+    if (l_infile)
+        dup_infile(l_infile);
+    if ((*cmd_line)->str[1])
+        execve_func((*cmd_line)->str + 1, env_list, (*cmd_line)->assigns);
+    g_shell.status = 0;
+}
+
+// The last command of the last input line has nothing to return to,
+// so it replaces the shell instead of paying for a fork and a wait
+int can_tail_exec(t_cmd_line *cmd)
+{
+    if (!g_shell.last_line || !cmd->str[0] || find_function(cmd->str[0])
+        || stages_pending() || g_shell.timing)
+        return (0);
+    if (builtin_code(cmd->str) || main_builtins(&cmd))
+        return (0);
+    return (1);
+}
+
+// A lone cat or parallel needs no fork: its redirections are applied
+// to the shell for as long as it runs
+void    run_redirected(t_cmd_line **cmd_line, int (*builtin)(char **))
+{
+    int saved[2];
+
+    if (!push_redirections(cmd_line, saved))
+    {
+        g_shell.status = 1;
+        return ;
+    }
+    g_shell.status = builtin((*cmd_line)->str);
+    pop_redirections(saved);
+}
@@ -0,0 +1,94 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   execution_list.c                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/18 16:20:41 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/18 16:20:41 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+// Shallow copy: expand() swaps values and types on the copy, so the
+// tokens kept in the tree stay unexpanded for the next run
+t_token_list	*copy_tokens(t_token_list *tokens)
+{
+	t_token_list	*copy;
+	t_token_list	*last;
+	t_token_list	*node;
+
+	copy = NULL;
+	last = NULL;
+	while (tokens)
+	{
+		node = new_token(tokens->value, tokens->type);
+		node->flags = tokens->flags;
+		if (!copy)
+			copy = node;
+		else
+			last->next = node;
+		last = node;
+		tokens = tokens->next;
+	}
+	return (copy);
+}
+
+t_cmd_line	*build_pipeline(t_token_list *tokens)
+{
+	t_token_list	*copy;
+	t_cmd_line		*cmd_line;
+
+	copy = copy_tokens(tokens);
+	expand(&copy, g_shell.env_list);
+	cmd_line = NULL;
+	parser(&cmd_line, copy);
+	ft_lstclear(&copy);
+	return (cmd_line);
+}
+
+void	run_pipeline(t_token_list *tokens)
+{
+	t_cmd_line	*cmd_line;
+	long		start;
+
+	start = trace_now();
+	cmd_line = build_pipeline(tokens);
+	trace_span("expand", start);
+	if (cmd_line)
+		execution(&cmd_line, g_shell.env_list, g_shell.export_list);
+	procsub_cleanup();
+	free_all(cmd_line);
+}
+
+// Only the very last pipeline of the input may be tail-exec'd
+void	run_list(t_node *node)
+{
+	int	last_line;
+
+	last_line = g_shell.last_line;
+	while (node && !g_shell.breaking && !g_shell.continuing)
+	{
+		g_shell.last_line = last_line && !node->next
+			&& (node->type == N_PIPELINE || node->type == N_GROUP
+				|| node->type == N_SUBSHELL);
+		if (node->type == N_PIPELINE)
+			run_pipeline(node->tokens);
+		else if (node->type == N_GROUP)
+			run_group(node);
+		else if (node->type == N_SUBSHELL)
+			run_subshell(node);
+		else if (node->type == N_PIPE)
+			run_pipe(node);
+		else if (node->type == N_FUNCDEF)
+			define_function(node);
+		else if (node->type == N_TIME)
+			run_timed(node);
+		else
+			run_loop(node);
+		node = node->next;
+	}
+	g_shell.last_line = last_line;
+}
@@ -54,7 +54,25 @@ void execute_command_2(t_cmd_line **cmd_line, t_env_list **env_list, t_export **
 {
 	int built_code;
 
-	built_code = builtins((*cmd_line)->str[0]);
+	if (!(*cmd_line)->str[0])
+		exit(0);
+	// builtins and functions see prefix assignments as variables of this
+	// child; the shell's own lists are never touched
+	if ((*cmd_line)->assigns && (find_function((*cmd_line)->str[0])
+			|| builtin_code((*cmd_line)->str)))
+		set_assignments((*cmd_line)->assigns);
+	if (find_function((*cmd_line)->str[0]))
+	{
+		call_function(find_function((*cmd_line)->str[0]), (*cmd_line)->str);
+		exit(g_shell.status);
+	}
+	if (!ft_strcmp((*cmd_line)->str[0], "exec"))
+	{
+		if ((*cmd_line)->str[1])
+			execve_func((*cmd_line)->str + 1, env_list, (*cmd_line)->assigns);
+		exit(0);
+	}
+	built_code = builtin_code((*cmd_line)->str);
 	if (built_code)
 	{
 		exec_builtins((*cmd_line)->str, env_list, built_code,export);
@@ -62,29 +80,38 @@ void execute_command_2(t_cmd_line **cmd_line, t_env_list **env_list, t_export **
 	else
 	{
 
-		execve_func((*cmd_line)->str, env_list);
+		execve_func((*cmd_line)->str, env_list, (*cmd_line)->assigns);
 	}
 }
 
-void execve_func(char **cmd, t_env_list **env_list)
+// overlay holds the command's prefix assignments, a PATH among them
+// also decides where the command is looked up
+void execve_func(char **cmd, t_env_list **env_list, char **overlay)
 {
 	char **path;
 	char *cmd_;
 	char **envp;
 
-	path = get_path(env_list);
-	if(cmd[0][0] != '/')
+	if (overlay_get(overlay, "PATH"))
+		path = ft_split(overlay_get(overlay, "PATH"), ':');
+	else
+		path = get_path(env_list);
+	if (!ft_strchr(cmd[0], '/'))
 		cmd_ = check_command_in_path(path, cmd[0]);
 	else
 		cmd_ = cmd[0];
-	envp = create_envp(env_list);
+	envp = overlay_envp(env_list, overlay);
 	if (!cmd_)
 	{
 		write( 1, "minishell: ", ft_strlen("minishell: "));
 		write (1, "Command not found\n", ft_strlen("Command not found\n"));
-		exit(0);
+		exit(127);
 	}
+	trace_instant("exec");
 	execve(cmd_, cmd, envp);
+	write(2, "minishell: ", ft_strlen("minishell: "));
+	perror(cmd[0]);
+	exit(126);
 }
 
 char *check_command_in_path(char **path, char *cmd)
@@ -93,7 +120,7 @@ char *check_command_in_path(char **path, char *cmd)
 
 	i = 0;
 	cmd = ft_strjoin("/", cmd);
-	while (path[i])
+	while (path && path[i])
 	{
 		if (!access(ft_strjoin(path[i], cmd), F_OK))
 		{
@@ -37,6 +37,7 @@ char	**get_path(t_env_list **env_list)
 	char		**path_splitted;
 
 	list = *env_list;
+	path = NULL;
 	while (list)
 	{
 		if (!(ft_strcmp(list->name, "PATH")))
@@ -88,14 +89,93 @@ char **create_envp(t_env_list **env_list)
 	char *tmp;
 
 	envlist = *env_list;
-	envp = malloc(sizeof(char *) * count_envlist(env_list) + 1);
+	envp = malloc(sizeof(char *) * (count_envlist(env_list) + 1));
 	i = 0;
 	while (envlist)
 	{
 		tmp = ft_strjoin(envlist->name, "=");
 		envp[i] = ft_strjoin(tmp, envlist->value);
+		free(tmp);
 		envlist = envlist->next;
 		i++;
 	}
+	envp[i] = NULL;
 	return (envp);
-}
\ No newline at end of file
+}
+
+// Both entries are NAME=value and share the NAME
+static int	same_name(char *a, char *b)
+{
+	int	len;
+
+	len = ft_strchr(a, '=') - a;
+	return (!ft_strncmp(a, b, len) && b[len] == '=');
+}
+
+// Value of name in a list of NAME=value words, the last one winning;
+// NULL when not there
+char	*overlay_get(char **overlay, char *name)
+{
+	char	*value;
+	int		len;
+	int		i;
+
+	value = NULL;
+	len = ft_strlen(name);
+	i = -1;
+	while (overlay && overlay[++i])
+		if (!ft_strncmp(overlay[i], name, len) && overlay[i][len] == '=')
+			value = overlay[i] + len + 1;
+	return (value);
+}
+
+// envp for one command run as VAR=val cmd: the shell's variables with
+// the prefix assignments laid over them. The lists are only read and
+// the overlay strings are pointed to, not copied
+char	**overlay_envp(t_env_list **env_list, char **overlay)
+{
+	t_env_list	*env;
+	char		**envp;
+	char		*tmp;
+	int			base;
+	int			i;
+	int			j;
+	int			n;
+
+	n = 0;
+	while (overlay && overlay[n])
+		n++;
+	if (!n)
+		return (create_envp(env_list));
+	envp = malloc(sizeof(char *) * (count_envlist(env_list) + n + 1));
+	i = 0;
+	env = *env_list;
+	while (env)
+	{
+		if (!overlay_get(overlay, env->name))
+		{
+			tmp = ft_strjoin(env->name, "=");
+			envp[i++] = ft_strjoin(tmp, env->value);
+			free(tmp);
+		}
+		env = env->next;
+	}
+	base = i;
+	while (n--)
+	{
+		j = base;
+		while (j < i && !same_name(envp[j], overlay[n]))
+			j++;
+		if (j == i)
+			envp[i++] = overlay[n];
+	}
+	envp[i] = NULL;
+	return (envp);
+}
+
+int	exit_code(int status)
+{
+	if (WIFSIGNALED(status))
+		return (128 + WTERMSIG(status));
+	return (WEXITSTATUS(status));
+}
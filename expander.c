@@ -23,7 +23,11 @@ void	expand(t_token_list **tokens, t_env_list **env)
 	token = *tokens;
 	while (token && token->type != NLINE)
 	{
-		if (token && token->type == AFDOLLAR)
+		if (token->type == AFDOLLAR && !ft_strcmp(token->value, "?"))
+			token->value = ft_itoa(g_shell.status);
+		else if (token->type == AFDOLLAR && is_positional(token->value))
+			token->value = positional(token->value);
+		else if (token && token->type == AFDOLLAR)
 		{
 			flag = 0;
 			envlist = *env;
@@ -39,6 +43,21 @@ void	expand(t_token_list **tokens, t_env_list **env)
 			if (flag == 0)
 				token->value = ft_strdup("\0");
 		}
+		else if (token->type == ARITH)
+		{
+			token->value = arith_expand(token->value);
+			token->type = WORD;
+		}
+		else if (token->type == CMDSUB)
+		{
+			token->value = cmdsub_capture(token->value);
+			token->type = WORD;
+		}
+		else if (token->type == PROCSUB_IN || token->type == PROCSUB_OUT)
+		{
+			token->value = procsub_spawn(token->value, token->type);
+			token->type = WORD;
+		}
 		token = token->next;
 	}
 }
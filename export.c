@@ -315,15 +315,20 @@ void    do_export(char *str[],t_export **data, t_env_list **env_list)
 		t_export *head = (*data);
 		while (head)
 		{
+			ft_putstr("declare -x ");
+			ft_putstr(head->var);
 			if(*(head->value) == '\0')
 			{
 				if(eqaul_last_only(head->var))
-					printf("declare -x %s\"\"\n",head->var);
-				else
-					printf("declare -x %s\n",head->var);
+					ft_putstr("\"\"");
 			}
 			else
-				 printf("declare -x %s=\"%s\"\n",head->var,head->value);
+			{
+				ft_putstr("=\"");
+				ft_putstr(head->value);
+				ft_putstr("\"");
+			}
+			ft_putstr("\n");
 			head = head->next;
 		}
 	}
@@ -336,4 +341,93 @@ void    do_export(char *str[],t_export **data, t_env_list **env_list)
 		i++;
 	}
 	 sort(data);
-}
\ No newline at end of file
+}
+
+// Sets one variable in both lists, as for loops and read need
+// A command of only NAME=value words sets them in the shell itself
+void	set_assignments(char **assigns)
+{
+	char	*name;
+	int		i;
+
+	i = -1;
+	while (assigns[++i])
+	{
+		name = ft_strndup(assigns[i],
+				ft_strchr(assigns[i], '=') - assigns[i]);
+		set_env_var(name, ft_strchr(assigns[i], '=') + 1);
+		free(name);
+	}
+	g_shell.status = 0;
+}
+
+void	set_env_var(char *name, char *value)
+{
+	t_env_list	*env;
+
+	value = ft_strdup(value);
+	if (check_if_in_env(name, value, *g_shell.export_list))
+		edit_value(name, value, g_shell.export_list, g_shell.env_list);
+	else
+		insert(g_shell.export_list, addnew(ft_strdup(name), value));
+	env = *g_shell.env_list;
+	while (env && ft_strcmp(env->name, name))
+		env = env->next;
+	if (!env)
+		addback_env(g_shell.env_list, addnew2(ft_strdup(name), value));
+}
+
+// Prefix assignments of a function run in the shell itself: the old
+// values (NULL where the variable was unset) are handed back so
+// pop_assignments can undo them once the call returns
+char	**push_assignments(char **assigns)
+{
+	t_env_list	*env;
+	char		**saved;
+	char		*name;
+	int			i;
+
+	i = 0;
+	while (assigns[i])
+		i++;
+	saved = malloc(sizeof(char *) * (i + 1));
+	i = -1;
+	while (assigns[++i])
+	{
+		name = ft_strndup(assigns[i],
+				ft_strchr(assigns[i], '=') - assigns[i]);
+		env = *g_shell.env_list;
+		while (env && ft_strcmp(env->name, name))
+			env = env->next;
+		saved[i] = NULL;
+		if (env)
+			saved[i] = ft_strdup(env->value);
+		free(name);
+	}
+	saved[i] = NULL;
+	set_assignments(assigns);
+	return (saved);
+}
+
+void	pop_assignments(char **assigns, char **saved)
+{
+	char	*name;
+	int		i;
+
+	i = -1;
+	while (assigns[++i])
+	{
+		name = ft_strndup(assigns[i],
+				ft_strchr(assigns[i], '=') - assigns[i]);
+		if (saved[i])
+			set_env_var(name, saved[i]);
+		else
+		{
+			removeNode(g_shell.export_list, name);
+			removeNode2(g_shell.env_list, name);
+		}
+		free(saved[i]);
+		free(name);
+	}
+	free(saved);
+}
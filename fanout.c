@@ -0,0 +1,369 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   fanout.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/20 15:42:08 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/20 15:42:08 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <errno.h>
+#include <poll.h>
+
+#define FANOUT_CHUNK 65536
+
+static int	fanout_error(char *msg)
+{
+	write(2, "minishell: fanout: ", 19);
+	write(2, msg, ft_strlen(msg));
+	write(2, "\n", 1);
+	return (2);
+}
+
+static void	drop_fan(t_fan *fan)
+{
+	if (fan->pipe[1] >= 0)
+		close(fan->pipe[1]);
+	if (fan->stage[0] >= 0)
+		close(fan->stage[0]);
+	if (fan->stage[1] >= 0)
+		close(fan->stage[1]);
+	fan->pipe[1] = -1;
+	fan->stage[0] = -1;
+	fan->stage[1] = -1;
+	fan->left = 0;
+}
+
+#ifdef __linux__
+
+// tee only reads from a pipe, so a file or a terminal on stdin is first
+// moved into one of our own; splice keeps a file's pages out of
+// userspace and whatever it refuses goes through read and write
+static int	feed_source(t_fanout *f)
+{
+	char	buf[FANOUT_CHUNK];
+	ssize_t	n;
+
+	if (f->feed < 0)
+		return (0);
+	n = splice(0, NULL, f->feed, NULL, f->chunk, SPLICE_F_MOVE);
+	if (n < 0 && errno == EINVAL)
+	{
+		if (f->chunk < (ssize_t) sizeof(buf))
+			n = read(0, buf, f->chunk);
+		else
+			n = read(0, buf, sizeof(buf));
+		if (n > 0 && write(f->feed, buf, n) != n)
+			n = -1;
+	}
+	if (n <= 0)
+	{
+		close(f->feed);
+		f->feed = -1;
+	}
+	return (-(n < 0));
+}
+
+// Every stage gets the source's size and then all of them the smallest
+// size any of them reached: empty pipes of one size accept the same
+// buffers, so each tee of a round takes exactly the same bytes
+static void	open_stages(t_fanout *f)
+{
+	struct stat	st;
+	int			fd[2];
+	int			size;
+	int			i;
+
+	if ((fstat(0, &st) || !S_ISFIFO(st.st_mode)) && !pipe_cloexec(fd))
+	{
+		f->src = fd[0];
+		f->feed = fd[1];
+	}
+	size = fcntl(f->src, F_GETPIPE_SZ);
+	f->chunk = size;
+	i = -1;
+	while (++i < f->n)
+	{
+		if (f->fans[i].pipe[1] < 0 || pipe_cloexec(f->fans[i].stage))
+			continue ;
+		if (size > 0)
+			fcntl(f->fans[i].stage[1], F_SETPIPE_SZ, size);
+		size = fcntl(f->fans[i].stage[1], F_GETPIPE_SZ);
+		if (size > 0 && (f->chunk <= 0 || size < f->chunk))
+			f->chunk = size;
+	}
+	while (--i >= 0)
+		if (f->fans[i].stage[1] >= 0)
+			fcntl(f->fans[i].stage[1], F_SETPIPE_SZ, f->chunk);
+	if (f->chunk <= 0)
+		f->chunk = FANOUT_CHUNK;
+}
+
+// One round: every live consumer but the last gets a tee of what the
+// source holds and the last one takes the same bytes with splice, which
+// also empties the source; only page references change hands
+static ssize_t	fill_stages(t_fanout *f)
+{
+	ssize_t	len;
+	ssize_t	n;
+	int		last;
+	int		i;
+
+	last = f->n;
+	while (--last >= 0 && f->fans[last].stage[1] < 0)
+		;
+	if (last < 0 || feed_source(f) < 0)
+		return (-(last >= 0));
+	len = f->chunk;
+	i = -1;
+	while (++i <= last)
+	{
+		if (f->fans[i].stage[1] < 0)
+			continue ;
+		if (i < last)
+			n = tee(f->src, f->fans[i].stage[1], len, 0);
+		else
+			n = splice(f->src, NULL, f->fans[i].stage[1], NULL, len,
+					SPLICE_F_MOVE);
+		if (n <= 0)
+			return (n);
+		len = n;
+		f->fans[i].left = n;
+	}
+	return (len);
+}
+
+static int	poll_stages(t_fanout *f, struct pollfd *pfd)
+{
+	int	m;
+	int	i;
+
+	m = 0;
+	i = -1;
+	while (++i < f->n)
+	{
+		if (f->fans[i].left == 0)
+			continue ;
+		pfd[m].fd = f->fans[i].pipe[1];
+		pfd[m].events = POLLOUT;
+		m++;
+	}
+	if (m == 0)
+		return (0);
+	if (poll(pfd, m, -1) < 0 && errno != EINTR)
+		return (0);
+	return (1);
+}
+
+// A new round waits until every stage has been passed on, so the
+// slowest consumer sets the pace and each one never has more than its
+// stage and its own pipe in flight; a consumer that exits is dropped
+static void	drain_stages(t_fanout *f, struct pollfd *pfd)
+{
+	ssize_t	n;
+	int		i;
+
+	while (poll_stages(f, pfd))
+	{
+		i = -1;
+		while (++i < f->n)
+		{
+			if (f->fans[i].left == 0)
+				continue ;
+			n = splice(f->fans[i].stage[0], NULL, f->fans[i].pipe[1], NULL,
+					f->fans[i].left, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			if (n > 0)
+				f->fans[i].left -= n;
+			else if (n == 0 || errno != EAGAIN)
+				drop_fan(&f->fans[i]);
+		}
+	}
+}
+
+static void	relay(t_fanout *f)
+{
+	struct pollfd	*pfd;
+	ssize_t			n;
+
+	open_stages(f);
+	pfd = malloc(sizeof(struct pollfd) * f->n);
+	n = fill_stages(f);
+	while (n > 0)
+	{
+		drain_stages(f, pfd);
+		n = fill_stages(f);
+	}
+	if (n < 0)
+		perror("minishell: fanout");
+	free(pfd);
+	if (f->feed >= 0)
+		close(f->feed);
+	if (f->src != 0)
+		close(f->src);
+}
+
+#else
+
+static void	relay(t_fanout *f)
+{
+	char	buf[FANOUT_CHUNK];
+	ssize_t	n;
+	ssize_t	w;
+	ssize_t	done;
+	int		i;
+
+	n = read(0, buf, sizeof(buf));
+	while (n > 0)
+	{
+		i = -1;
+		while (++i < f->n)
+		{
+			done = 0;
+			while (f->fans[i].pipe[1] >= 0 && done < n)
+			{
+				w = write(f->fans[i].pipe[1], buf + done, n - done);
+				if (w < 0)
+					drop_fan(&f->fans[i]);
+				done += w;
+			}
+		}
+		n = read(0, buf, sizeof(buf));
+	}
+}
+
+#endif
+
+// A consumer only keeps its own read end: a builtin or a loop running
+// in the child must not hold the other consumers' pipes open
+static void	consumer(t_fanout *f, int i, t_node *tree)
+{
+	int	j;
+
+	dup2(f->fans[i].pipe[0], 0);
+	close(f->fans[i].pipe[0]);
+	j = -1;
+	while (++j <= i)
+		if (f->fans[j].pipe[1] >= 0)
+			close(f->fans[j].pipe[1]);
+	g_shell.last_line = 1;
+	run_list(tree);
+	exit(g_shell.status);
+}
+
+static void	spawn_consumers(t_fanout *f, t_node **trees)
+{
+	long	start;
+	int		i;
+
+	tune_pipeline();
+	i = -1;
+	while (++i < f->n)
+	{
+		f->fans[i].pid = -1;
+		f->fans[i].left = 0;
+		f->fans[i].stage[0] = -1;
+		f->fans[i].stage[1] = -1;
+		f->fans[i].pipe[1] = -1;
+		if (pipe_cloexec(f->fans[i].pipe))
+			continue ;
+		tune_pipe(f->fans[i].pipe);
+		start = trace_now();
+		f->fans[i].pid = fork();
+		trace_fork(f->fans[i].pid, "fanout", start);
+		if (f->fans[i].pid == 0)
+			consumer(f, i, trees[i]);
+		close(f->fans[i].pipe[0]);
+		if (f->fans[i].pid < 0)
+			drop_fan(&f->fans[i]);
+	}
+}
+
+// Every pipe is closed before the first wait, so each consumer sees
+// its end of input whatever order they finish in
+static int	wait_consumers(t_fanout *f, t_node **trees)
+{
+	int	status;
+	int	code;
+	int	i;
+
+	i = -1;
+	while (++i < f->n)
+		drop_fan(&f->fans[i]);
+	code = 1;
+	i = -1;
+	while (++i < f->n)
+	{
+		if (f->fans[i].pid > 0
+			&& wait_stage(f->fans[i].pid, &status, "fanout") > 0)
+			code = exit_code(status);
+		else
+			code = 1;
+		free_tree(trees[i]);
+	}
+	return (code);
+}
+
+// The commands are parsed up front so a typo is reported before
+// anything is read from stdin
+static t_node	**parse_consumers(char **cmds, int n)
+{
+	t_node	**trees;
+	char	*err;
+	int		state;
+	int		i;
+
+	trees = malloc(sizeof(t_node *) * n);
+	i = 0;
+	while (i < n)
+	{
+		trees[i] = parse_tree(cmds[i], &state, &err);
+		if (state != P_DONE)
+		{
+			if (state == P_INCOMPLETE)
+				err = "unexpected end of file";
+			else if (!err)
+				err = "parse error";
+			fanout_error(err);
+			while (i >= 0)
+				free_tree(trees[i--]);
+			free(trees);
+			return (NULL);
+		}
+		i++;
+	}
+	return (trees);
+}
+
+// fanout CMD...: runs every CMD with its own copy of stdin; the status
+// is the last consumer's, as for the last stage of a pipeline
+int	ft_fanout(char **argv)
+{
+	t_fanout	f;
+	t_node		**trees;
+	void		(*sigpipe)(int);
+	int			status;
+
+	f.n = 0;
+	while (argv[f.n + 1])
+		f.n++;
+	if (!f.n)
+		return (fanout_error("usage: fanout command..."));
+	trees = parse_consumers(argv + 1, f.n);
+	if (!trees)
+		return (2);
+	f.fans = malloc(sizeof(t_fan) * f.n);
+	f.src = 0;
+	f.feed = -1;
+	spawn_consumers(&f, trees);
+	sigpipe = signal(SIGPIPE, SIG_IGN);
+	relay(&f);
+	signal(SIGPIPE, sigpipe);
+	status = wait_consumers(&f, trees);
+	free(trees);
+	free(f.fans);
+	return (status);
+}
@@ -0,0 +1,119 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   fds.c                                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/27 10:21:36 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/27 10:21:36 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+
+// Every pipe the shell makes starts close-on-exec; the ends a command
+// needs are placed on 0/1 with dup2, which clears the flag on the copy
+int	pipe_cloexec(int fd[2])
+{
+#ifdef __linux__
+	return (pipe2(fd, O_CLOEXEC));
+#else
+	if (pipe(fd) == -1)
+		return (-1);
+	fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+	fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+	return (0);
+#endif
+}
+
+static t_fdcheck	*get_fdcheck(void)
+{
+	static t_fdcheck	check = {0, -1, -1};
+
+	return (&check);
+}
+
+// MINISHELL_FDCHECK=1 counts the open fds after every prompt cycle and
+// reports any growth on stderr
+void	fd_check_init(void)
+{
+	char	*value;
+
+	value = getenv("MINISHELL_FDCHECK");
+	get_fdcheck()->enabled = (value && *value && ft_strcmp(value, "0"));
+}
+
+static int	is_open(int fd)
+{
+	return (fcntl(fd, F_GETFD) != -1);
+}
+
+static void	report_fds(int count)
+{
+	char	path[64];
+	char	target[256];
+	ssize_t	n;
+	int		fd;
+
+	dprintf(2, "minishell: fd check: %d open (%+d since last prompt, "
+		"%+d since start)\n", count, count - get_fdcheck()->last,
+		count - get_fdcheck()->first);
+	fd = 2;
+	while (++fd < FDCHECK_MAX)
+	{
+		if (!is_open(fd))
+			continue ;
+		snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+		n = readlink(path, target, sizeof(target) - 1);
+		if (n < 0)
+			n = 0;
+		target[n] = '\0';
+		dprintf(2, "  fd %d%s%s%s\n", fd, n ? " -> " : "", target,
+			(fcntl(fd, F_GETFD) & FD_CLOEXEC) ? "" : " (inherited)");
+	}
+}
+
+// /proc/self/fd when there is one, a probe of the low fds otherwise
+static int	count_fds(void)
+{
+	DIR				*dir;
+	struct dirent	*entry;
+	int				count;
+	int				fd;
+
+	count = 0;
+	dir = opendir("/proc/self/fd");
+	if (!dir)
+	{
+		fd = -1;
+		while (++fd < FDCHECK_MAX)
+			count += is_open(fd);
+		return (count);
+	}
+	entry = readdir(dir);
+	while (entry)
+	{
+		count += (entry->d_name[0] != '.');
+		entry = readdir(dir);
+	}
+	closedir(dir);
+	return (count - 1);
+}
+
+void	fd_check(void)
+{
+	t_fdcheck	*check;
+	int			count;
+
+	check = get_fdcheck();
+	if (!check->enabled)
+		return ;
+	count = count_fds();
+	if (check->first < 0)
+		check->first = count;
+	else if (count > check->last)
+		report_fds(count);
+	check->last = count;
+}
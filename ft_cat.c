@@ -0,0 +1,174 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ft_cat.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/20 11:15:07 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/20 11:15:07 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <errno.h>
+#ifdef __linux__
+# include <sys/sendfile.h>
+#endif
+
+#define CAT_CHUNK 1048576
+
+static int	cat_error(char *name, char *msg)
+{
+	write(2, "minishell: cat: ", 16);
+	write(2, name, ft_strlen(name));
+	write(2, ": ", 2);
+	write(2, msg, ft_strlen(msg));
+	write(2, "\n", 1);
+	return (1);
+}
+
+static int	copy_rw(int in, int out)
+{
+	char	buf[65536];
+	ssize_t	n;
+	ssize_t	w;
+	ssize_t	done;
+
+	n = read(in, buf, sizeof(buf));
+	while (n > 0)
+	{
+		done = 0;
+		while (done < n)
+		{
+			w = write(out, buf + done, n - done);
+			if (w < 0)
+				return (-1);
+			done += w;
+		}
+		n = read(in, buf, sizeof(buf));
+	}
+	return (n);
+}
+
+#ifdef __linux__
+
+// Each fast path returns 1 when it moved everything, 0 when the kernel
+// refused it before the first byte (so a slower path can take over)
+// and -1 on a real error; an O_APPEND output is refused with EBADF
+static int	copy_kernel(int in, int out, int how)
+{
+	ssize_t	n;
+	int		moved;
+
+	moved = 0;
+	while (1)
+	{
+		if (how == 0)
+			n = copy_file_range(in, NULL, out, NULL, CAT_CHUNK, 0);
+		else if (how == 1)
+			n = splice(in, NULL, out, NULL, CAT_CHUNK, SPLICE_F_MOVE);
+		else
+			n = sendfile(out, in, NULL, CAT_CHUNK);
+		if (n == 0)
+			return (1);
+		if (n < 0 && !moved && (errno == EINVAL || errno == ENOSYS
+				|| errno == EXDEV || errno == EOPNOTSUPP
+				|| errno == EBADF))
+			return (0);
+		if (n < 0)
+			return (-1);
+		moved = 1;
+	}
+}
+
+#endif
+
+// Picks the cheapest way the two fd types allow: copy_file_range between
+// regular files, splice when either end is a pipe, sendfile out of a
+// regular file, and read/write for everything else
+static int	copy_fd(int in, int out)
+{
+	int			ret;
+	struct stat	st_in;
+	struct stat	st_out;
+
+	ret = 0;
+#ifdef __linux__
+	if (fstat(in, &st_in) || fstat(out, &st_out))
+		return (-1);
+	if (S_ISREG(st_in.st_mode) && S_ISREG(st_out.st_mode))
+		ret = copy_kernel(in, out, 0);
+	if (!ret && (S_ISFIFO(st_in.st_mode) || S_ISFIFO(st_out.st_mode)))
+		ret = copy_kernel(in, out, 1);
+	if (!ret && S_ISREG(st_in.st_mode))
+		ret = copy_kernel(in, out, 2);
+	if (ret)
+		return (ret);
+#endif
+	return (copy_rw(in, out));
+}
+
+static int	same_file(int in, int out)
+{
+	struct stat	st_in;
+	struct stat	st_out;
+
+	if (fstat(in, &st_in) || fstat(out, &st_out))
+		return (0);
+	return (S_ISREG(st_in.st_mode) && st_in.st_dev == st_out.st_dev
+		&& st_in.st_ino == st_out.st_ino);
+}
+
+static int	cat_one(char *name, int out)
+{
+	int	in;
+	int	ret;
+
+	in = 0;
+	ret = 0;
+	if (ft_strcmp(name, "-"))
+		in = open(name, O_RDONLY | O_CLOEXEC);
+	if (in < 0)
+		return (cat_error(name, strerror(errno)));
+	if (same_file(in, out))
+		ret = cat_error(name, "input file is output file");
+	else if (g_shell.capture)
+		buf_read_fd(g_shell.capture, in);
+	else if (copy_fd(in, out) < 0)
+		ret = cat_error(name, strerror(errno));
+	if (in != 0)
+		close(in);
+	return (ret);
+}
+
+// Only plain file operands are handled here; anything with an option
+// is left to the external cat
+int	cat_options(char **str)
+{
+	int	i;
+
+	i = 1;
+	while (str[i])
+	{
+		if (str[i][0] == '-' && str[i][1])
+			return (1);
+		i++;
+	}
+	return (0);
+}
+
+int	ft_cat(char **str)
+{
+	int	status;
+	int	i;
+
+	if (!str[1])
+		return (cat_one("-", 1));
+	status = 0;
+	i = 1;
+	while (str[i])
+		status |= cat_one(str[i++], 1);
+	return (status);
+}
@@ -41,7 +41,7 @@ void	heredoc_prompt(char *delimiter, int fd)
 
 	while (1337)
 	{
-		buffer = readline("> ");
+		buffer = read_line("> ");
 		if (!buffer)
 			break ;
 		if (!(ft_strcmp(buffer, delimiter)))
@@ -60,8 +60,10 @@ void    ft_heredoc(t_cmd_line **cmd_line, int *fd)
 	delimiters = get_delimiters(cmd_line);
 	while (i < count_heredocs(cmd_line))
 	{
-		*fd = open("heredoc", O_CREAT | O_TRUNC | O_WRONLY, 0777);
+		*fd = open("heredoc", O_CREAT | O_TRUNC | O_WRONLY | O_CLOEXEC, 0777);
 		heredoc_prompt(delimiters[i], *fd);
+		close(*fd);
 		i++;
 	}
+	free(delimiters);
 }
\ No newline at end of file
@@ -0,0 +1,184 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ft_read.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/09 12:08:33 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/09 12:08:33 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static char	*get_read_buf(void)
+{
+	static char	buf[READ_CHUNK];
+
+	return (buf);
+}
+
+// Regular files are read a chunk at a time and the offset is moved
+// back to just past the newline, so the next reader of the fd starts
+// on the following line. Returns 1 when the newline was reached
+static int	read_chunks(int fd, t_buf *line)
+{
+	char	*buf;
+	char	*nl;
+	ssize_t	n;
+
+	buf = get_read_buf();
+	while (1)
+	{
+		n = read(fd, buf, READ_CHUNK);
+		if (n <= 0)
+			return (0);
+		nl = memchr(buf, '\n', n);
+		if (!nl)
+		{
+			buf_append(line, buf, n);
+			continue ;
+		}
+		buf_append(line, buf, nl - buf);
+		lseek(fd, (nl + 1 - buf) - n, SEEK_CUR);
+		return (1);
+	}
+}
+
+// A pipe or a tty cannot be given back what was read past the newline,
+// so there it goes one byte at a time
+static int	read_bytes(int fd, t_buf *line)
+{
+	char	c;
+
+	while (read(fd, &c, 1) == 1)
+	{
+		if (c == '\n')
+			return (1);
+		buf_append(line, &c, 1);
+	}
+	return (0);
+}
+
+// Without -r a backslash at the end of the line joins the next one
+static int	read_logical_line(int fd, t_buf *line, int raw)
+{
+	int		seekable;
+	int		nl;
+	size_t	n;
+
+	seekable = (lseek(fd, 0, SEEK_CUR) != -1);
+	while (1)
+	{
+		nl = -1;
+		if (fd == 0)
+			nl = input_take_line(line);
+		if (nl < 0 && seekable)
+			nl = read_chunks(fd, line);
+		else if (nl < 0)
+			nl = read_bytes(fd, line);
+		n = 0;
+		while (n < line->len && line->data[line->len - n - 1] == '\\')
+			n++;
+		if (raw || !nl || n % 2 == 0)
+			return (nl);
+		line->len--;
+	}
+}
+
+static int	is_blank(char c)
+{
+	return (c == ' ' || c == '\t');
+}
+
+// Cuts the next field out of *line where it stands: escapes are
+// removed in place and the end is NUL-terminated, so the value goes to
+// set_env_var without another copy. rest takes everything left, minus
+// trailing blanks
+static char	*next_field(char **line, int raw, int rest)
+{
+	char	*r;
+	char	*w;
+	char	*start;
+	char	*keep;
+
+	r = *line;
+	while (is_blank(*r))
+		r++;
+	start = r;
+	w = r;
+	keep = r;
+	while (*r && (rest || !is_blank(*r)))
+	{
+		if (rest && is_blank(*r))
+		{
+			*w++ = *r++;
+			continue ;
+		}
+		if (!raw && *r == '\\' && r[1])
+			r++;
+		*w++ = *r++;
+		keep = w;
+	}
+	if (*r)
+		r++;
+	*keep = '\0';
+	*line = r;
+	return (start);
+}
+
+static int	valid_names(char **names)
+{
+	int	i;
+	int	j;
+
+	i = -1;
+	while (names[++i])
+	{
+		j = 0;
+		while (names[i][j] == '_' || ft_isalnum(names[i][j]))
+			j++;
+		if (!j || names[i][j] || (names[i][0] >= '0' && names[i][0] <= '9'))
+		{
+			write(2, "minishell: read: `", 18);
+			write(2, names[i], ft_strlen(names[i]));
+			write(2, "': not a valid identifier\n", 26);
+			return (0);
+		}
+	}
+	return (1);
+}
+
+// read [-r] [NAME...]: one line of stdin split on blanks, the last name
+// taking the rest of the line; REPLY when no name is given. 1 at end of
+// input, after assigning whatever was read
+int	ft_read(char **argv)
+{
+	t_buf	line;
+	char	*reply[2];
+	char	*rest;
+	int		raw;
+	int		nl;
+
+	raw = (argv[1] && !ft_strcmp(argv[1], "-r"));
+	argv += 1 + raw;
+	reply[0] = "REPLY";
+	reply[1] = NULL;
+	if (!*argv)
+		argv = reply;
+	if (!valid_names(argv))
+		return (2);
+	memset(&line, 0, sizeof(t_buf));
+	buf_grow(&line, 0);
+	nl = read_logical_line(0, &line, raw);
+	line.data[line.len] = '\0';
+	rest = line.data;
+	while (*argv)
+	{
+		set_env_var(*argv, next_field(&rest, raw, argv[1] == NULL));
+		argv++;
+	}
+	free(line.data);
+	return (!nl);
+}
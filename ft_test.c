@@ -0,0 +1,223 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ft_test.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/17 17:20:33 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/17 17:20:33 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static int	test_or(t_test *t);
+
+static int	test_error(t_test *t, char *msg, char *arg)
+{
+	if (!t->err)
+	{
+		write(2, "minishell: test: ", 17);
+		if (arg)
+		{
+			write(2, arg, ft_strlen(arg));
+			write(2, ": ", 2);
+		}
+		write(2, msg, ft_strlen(msg));
+		write(2, "\n", 1);
+	}
+	t->err = 1;
+	return (0);
+}
+
+static int	to_integer(t_test *t, char *s, long long *n)
+{
+	int	i;
+	int	neg;
+
+	i = 0;
+	while (s[i] == ' ' || s[i] == '\t')
+		i++;
+	neg = (s[i] == '-');
+	i += (s[i] == '-' || s[i] == '+');
+	if (!(s[i] >= '0' && s[i] <= '9'))
+		return (test_error(t, "integer expression expected", s));
+	*n = 0;
+	while (s[i] >= '0' && s[i] <= '9')
+		*n = *n * 10 + (s[i++] - '0');
+	if (s[i])
+		return (test_error(t, "integer expression expected", s));
+	if (neg)
+		*n = -*n;
+	return (1);
+}
+
+// File tests cost one syscall each: stat for type and size,
+// access for permissions
+static int	unary(t_test *t, char op, char *arg)
+{
+	struct stat	st;
+
+	if (op == 'n' || op == 'z')
+		return ((*arg != '\0') == (op == 'n'));
+	if (op == 'r')
+		return (!access(arg, R_OK));
+	if (op == 'w')
+		return (!access(arg, W_OK));
+	if (op == 'x')
+		return (!access(arg, X_OK));
+	if (op == 'L' || op == 'h')
+		return (!lstat(arg, &st) && S_ISLNK(st.st_mode));
+	if (stat(arg, &st) == -1)
+		return (0);
+	if (op == 'f')
+		return (S_ISREG(st.st_mode));
+	if (op == 'd')
+		return (S_ISDIR(st.st_mode));
+	if (op == 's')
+		return (st.st_size > 0);
+	if (op == 'e')
+		return (1);
+	return (test_error(t, "unary operator expected", arg));
+}
+
+static int	is_binary(char *s)
+{
+	static char	*ops[] = {"=", "==", "!=", "-eq", "-ne", "-lt", "-le",
+		"-gt", "-ge", NULL};
+	int			i;
+
+	i = 0;
+	while (s && ops[i])
+	{
+		if (!ft_strcmp(s, ops[i]))
+			return (i + 1);
+		i++;
+	}
+	return (0);
+}
+
+static int	binary(t_test *t, char *l, int op, char *r)
+{
+	long long	a;
+	long long	b;
+
+	if (op <= 2)
+		return (!ft_strcmp(l, r));
+	if (op == 3)
+		return (ft_strcmp(l, r) != 0);
+	if (!to_integer(t, l, &a) || !to_integer(t, r, &b))
+		return (0);
+	if (op == 4)
+		return (a == b);
+	if (op == 5)
+		return (a != b);
+	if (op == 6)
+		return (a < b);
+	if (op == 7)
+		return (a <= b);
+	if (op == 8)
+		return (a > b);
+	return (a >= b);
+}
+
+static int	test_primary(t_test *t)
+{
+	char	**av;
+	int		ret;
+
+	av = t->av + t->pos;
+	if (t->pos >= t->ac)
+		return (test_error(t, "argument expected", NULL));
+	if (!ft_strcmp(av[0], "(") && t->pos + 1 < t->ac
+		&& (t->pos + 2 >= t->ac || !is_binary(av[1])))
+	{
+		t->pos++;
+		ret = test_or(t);
+		if (t->pos >= t->ac || ft_strcmp(t->av[t->pos], ")"))
+			return (test_error(t, "')' expected", NULL));
+		t->pos++;
+		return (ret);
+	}
+	if (t->pos + 2 < t->ac && is_binary(av[1]))
+	{
+		t->pos += 3;
+		return (binary(t, av[0], is_binary(av[1]), av[2]));
+	}
+	if (av[0][0] == '-' && av[0][1] && !av[0][2] && t->pos + 1 < t->ac)
+	{
+		t->pos += 2;
+		return (unary(t, av[0][1], av[1]));
+	}
+	t->pos++;
+	return (av[0][0] != '\0');
+}
+
+static int	test_not(t_test *t)
+{
+	if (t->pos < t->ac && !ft_strcmp(t->av[t->pos], "!")
+		&& t->pos + 1 < t->ac)
+	{
+		t->pos++;
+		return (!test_not(t));
+	}
+	return (test_primary(t));
+}
+
+static int	test_and(t_test *t)
+{
+	int	ret;
+
+	ret = test_not(t);
+	while (!t->err && t->pos < t->ac && !ft_strcmp(t->av[t->pos], "-a"))
+	{
+		t->pos++;
+		ret = test_not(t) && ret;
+	}
+	return (ret);
+}
+
+static int	test_or(t_test *t)
+{
+	int	ret;
+
+	ret = test_and(t);
+	while (!t->err && t->pos < t->ac && !ft_strcmp(t->av[t->pos], "-o"))
+	{
+		t->pos++;
+		ret = test_and(t) || ret;
+	}
+	return (ret);
+}
+
+// Returns the exit status: 0 true, 1 false, 2 usage error
+int	ft_test(char **str)
+{
+	t_test	t;
+	int		ret;
+
+	t.av = str + 1;
+	t.ac = 0;
+	while (t.av[t.ac])
+		t.ac++;
+	if (!ft_strcmp(str[0], "["))
+	{
+		if (!t.ac || ft_strcmp(t.av[t.ac - 1], "]"))
+		{
+			write(2, "minishell: [: missing `]'\n", 26);
+			return (2);
+		}
+		t.ac--;
+	}
+	if (!t.ac)
+		return (1);
+	t.pos = 0;
+	t.err = 0;
+	ret = test_or(&t);
+	if (!t.err && t.pos < t.ac)
+		test_error(&t, "too many arguments", NULL);
+	if (t.err)
+		return (2);
+	return (!ret);
+}
@@ -0,0 +1,184 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ft_time.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/23 18:27:40 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/23 18:27:40 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+// time [-v] COMMAND: the command is parsed like any other, -v adds a
+// line per waited stage to the summary
+t_node	*parse_time(t_parse *p)
+{
+	t_node	*node;
+
+	node = new_node(N_TIME);
+	p->tok = p->tok->next;
+	while (p->tok && p->tok->type == SPACE)
+		p->tok = p->tok->next;
+	if (is_keyword(p->tok, "-v"))
+	{
+		node->opts = 1;
+		p->tok = p->tok->next;
+		while (p->tok && p->tok->type == SPACE)
+			p->tok = p->tok->next;
+	}
+	if (!p->tok || p->tok->type == NLINE || p->tok->type == SEMI)
+		return (node);
+	node->body = parse_command(p);
+	if (!node->body)
+	{
+		free_tree(node);
+		return (NULL);
+	}
+	return (node);
+}
+
+// Stages are reaped with wait4 while a time is running so their
+// accounting is kept instead of discarded; either way the reap ends the
+// stage's span in the trace
+pid_t	wait_stage(pid_t pid, int *status, char *name)
+{
+	t_stage_usage	*stage;
+	pid_t			ret;
+
+	if (!g_shell.timing)
+	{
+		ret = waitpid(pid, status, 0);
+		trace_reap(pid);
+		return (ret);
+	}
+	stage = malloc(sizeof(t_stage_usage));
+	memset(stage, 0, sizeof(t_stage_usage));
+	ret = wait4(pid, status, 0, &stage->usage);
+	trace_reap(pid);
+	if (ret <= 0)
+	{
+		free(stage);
+		return (ret);
+	}
+	stage->name = ft_strdup(name);
+	if (g_shell.timing->last)
+		g_shell.timing->last->next = stage;
+	else
+		g_shell.timing->stages = stage;
+	g_shell.timing->last = stage;
+	return (ret);
+}
+
+static long	usec(struct timeval tv)
+{
+	return (tv.tv_sec * 1000000L + tv.tv_usec);
+}
+
+static void	print_line(char *name, long us)
+{
+	dprintf(2, "%s\t%ldm%ld.%03lds\n", name, us / 60000000L,
+		us / 1000000L % 60, us / 1000L % 1000);
+}
+
+static void	print_stage(char *name, struct rusage *usage)
+{
+	dprintf(2, "  %-12s user %ld.%03lds  sys %ld.%03lds  maxrss %ldk"
+		"  ctxsw %ld/%ld\n", name,
+		usec(usage->ru_utime) / 1000000L, usec(usage->ru_utime) / 1000L % 1000,
+		usec(usage->ru_stime) / 1000000L, usec(usage->ru_stime) / 1000L % 1000,
+		usage->ru_maxrss, usage->ru_nvcsw, usage->ru_nivcsw);
+}
+
+// Children are summed and their peak RSS kept; the shell's own share
+// (builtins, expansions) is added from its RUSAGE_SELF delta
+static void	report(t_timing *t, long real, struct rusage *self, int verbose)
+{
+	t_stage_usage	*stage;
+	long			user;
+	long			sys;
+	long			rss;
+	long			csw[2];
+
+	user = usec(self->ru_utime);
+	sys = usec(self->ru_stime);
+	rss = 0;
+	csw[0] = self->ru_nvcsw;
+	csw[1] = self->ru_nivcsw;
+	stage = t->stages;
+	while (stage)
+	{
+		user += usec(stage->usage.ru_utime);
+		sys += usec(stage->usage.ru_stime);
+		if (stage->usage.ru_maxrss > rss)
+			rss = stage->usage.ru_maxrss;
+		csw[0] += stage->usage.ru_nvcsw;
+		csw[1] += stage->usage.ru_nivcsw;
+		stage = stage->next;
+	}
+	write(2, "\n", 1);
+	print_line("real", real);
+	print_line("user", user);
+	print_line("sys", sys);
+	stage = t->stages;
+	while (verbose && stage)
+	{
+		print_stage(stage->name, &stage->usage);
+		stage = stage->next;
+	}
+	if (verbose)
+	{
+		self->ru_maxrss = 0;
+		print_stage("(shell)", self);
+	}
+	dprintf(2, "maxrss\t%ldk\nctxsw\t%ld voluntary, %ld involuntary\n",
+		rss, csw[0], csw[1]);
+}
+
+static void	self_delta(struct rusage *start, struct rusage *end)
+{
+	end->ru_utime.tv_sec -= start->ru_utime.tv_sec;
+	end->ru_utime.tv_usec -= start->ru_utime.tv_usec;
+	end->ru_stime.tv_sec -= start->ru_stime.tv_sec;
+	end->ru_stime.tv_usec -= start->ru_stime.tv_usec;
+	end->ru_nvcsw -= start->ru_nvcsw;
+	end->ru_nivcsw -= start->ru_nivcsw;
+}
+
+void	run_timed(t_node *node)
+{
+	t_timing		timing;
+	t_timing		*saved;
+	struct timespec	ts[2];
+	struct rusage	self[2];
+	t_stage_usage	*next;
+
+	memset(&timing, 0, sizeof(t_timing));
+	saved = g_shell.timing;
+	g_shell.timing = &timing;
+	clock_gettime(CLOCK_MONOTONIC, &ts[0]);
+	getrusage(RUSAGE_SELF, &self[0]);
+	run_list(node->body);
+	getrusage(RUSAGE_SELF, &self[1]);
+	clock_gettime(CLOCK_MONOTONIC, &ts[1]);
+	g_shell.timing = saved;
+	self_delta(&self[0], &self[1]);
+	report(&timing, (ts[1].tv_sec - ts[0].tv_sec) * 1000000L
+		+ (ts[1].tv_nsec - ts[0].tv_nsec) / 1000, &self[1], node->opts);
+	// an enclosing time takes the stages over once they are reported
+	if (saved && saved->last)
+		saved->last->next = timing.stages;
+	else if (saved)
+		saved->stages = timing.stages;
+	if (saved && timing.last)
+		saved->last = timing.last;
+	while (!saved && timing.stages)
+	{
+		next = timing.stages->next;
+		free(timing.stages->name);
+		free(timing.stages);
+		timing.stages = next;
+	}
+}
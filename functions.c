@@ -0,0 +1,113 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   functions.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/19 10:34:18 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/19 10:34:18 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static t_token_list	*skip_spaces(t_token_list *token)
+{
+	while (token && token->type == SPACE)
+		token = token->next;
+	return (token);
+}
+
+// NAME ( ) at command position starts a definition
+int	is_funcdef(t_token_list *token)
+{
+	if (!token || token->type != WORD || (token->flags & T_QUOTED)
+		|| !correct_name(token->value) || ft_strchr(token->value, '+')
+		|| (token->value[0] >= '0' && token->value[0] <= '9'))
+		return (0);
+	token = skip_spaces(token->next);
+	if (!token || token->type != PAREN_OPEN)
+		return (0);
+	token = skip_spaces(token->next);
+	return (token && token->type == PAREN_CLOSE);
+}
+
+// NAME() { LIST; } -- the body is kept parsed, never re-lexed
+t_node	*parse_function(t_parse *p)
+{
+	t_node	*node;
+
+	node = new_node(N_FUNCDEF);
+	node->var = ft_strdup(p->tok->value);
+	p->tok = skip_spaces(skip_spaces(p->tok->next)->next)->next;
+	skip_separators(p);
+	if (!p->tok || p->tok->type == NLINE)
+		p->state = P_INCOMPLETE;
+	else if (!is_keyword(p->tok, "{"))
+		p->state = P_ERROR;
+	else
+	{
+		p->tok = p->tok->next;
+		node->body = parse_list(p, "}");
+		skip_separators(p);
+		if (p->state == P_DONE && (!p->tok || p->tok->type == NLINE))
+			p->state = P_INCOMPLETE;
+		else if (p->state == P_DONE && node->body)
+			p->tok = p->tok->next;
+		else if (p->state == P_DONE)
+			p->state = P_ERROR;
+	}
+	if (p->state == P_ERROR)
+		parse_error(p);
+	if (p->state == P_DONE)
+		return (node);
+	free_tree(node);
+	return (NULL);
+}
+
+t_node	*copy_tree(t_node *node)
+{
+	t_node	*copy;
+
+	if (!node)
+		return (NULL);
+	copy = new_node(node->type);
+	copy->opts = node->opts;
+	copy->tokens = copy_tokens(node->tokens);
+	copy->words = copy_tokens(node->words);
+	if (node->var)
+		copy->var = ft_strdup(node->var);
+	copy->cond = copy_tree(node->cond);
+	copy->body = copy_tree(node->body);
+	copy->next = copy_tree(node->next);
+	return (copy);
+}
+
+t_func	*find_function(char *name)
+{
+	t_func	*func;
+
+	func = g_shell.functions;
+	while (name && func && ft_strcmp(func->name, name))
+		func = func->next;
+	return (func);
+}
+
+// The table keeps its own copy so the definition outlives the line it
+// came from; a replaced body is left alone since it may still be running
+void	define_function(t_node *node)
+{
+	t_func	*func;
+
+	func = find_function(node->var);
+	if (!func)
+	{
+		func = malloc(sizeof(t_func));
+		func->name = ft_strdup(node->var);
+		func->next = g_shell.functions;
+		g_shell.functions = func;
+	}
+	func->body = copy_tree(node->body);
+	g_shell.status = 0;
+}
@@ -0,0 +1,89 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   functions_call.c                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/19 12:02:44 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/19 12:02:44 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+void	call_function(t_func *func, char **argv)
+{
+	char	**params;
+
+	params = g_shell.params;
+	g_shell.params = argv;
+	run_list(func->body);
+	g_shell.params = params;
+}
+
+// A call that is not piped runs in the shell itself, redirections
+// included, so it can change the environment and the cwd; its prefix
+// assignments only last for the call
+void	run_function(t_cmd_line **cmd_line)
+{
+	int		saved[2];
+	int		fd;
+	char	**values;
+
+	ft_heredoc(cmd_line, &fd);
+	if (!push_redirections(cmd_line, saved))
+	{
+		g_shell.status = 1;
+		return ;
+	}
+	values = NULL;
+	if ((*cmd_line)->assigns)
+		values = push_assignments((*cmd_line)->assigns);
+	call_function(find_function((*cmd_line)->str[0]), (*cmd_line)->str);
+	if (values)
+		pop_assignments((*cmd_line)->assigns, values);
+	pop_redirections(saved);
+}
+
+int	is_positional(char *name)
+{
+	return ((name[0] >= '0' && name[0] <= '9') || !ft_strcmp(name, "#")
+		|| !ft_strcmp(name, "@"));
+}
+
+// $0-$9, $# and $@ of the running function
+char	*positional(char *name)
+{
+	int		count;
+	char	*all;
+	char	*tmp;
+
+	count = 0;
+	while (g_shell.params && g_shell.params[count])
+		count++;
+	if (name[0] == '#')
+		return (ft_itoa(count - (count > 0)));
+	if (name[0] == '0' && !count)
+		return (ft_strdup("minishell"));
+	if (name[0] != '@')
+	{
+		if (name[0] - '0' < count)
+			return (ft_strdup(g_shell.params[name[0] - '0']));
+		return (ft_strdup(""));
+	}
+	all = ft_strdup("");
+	count = 0;
+	while (g_shell.params && g_shell.params[++count])
+	{
+		tmp = all;
+		if (count > 1)
+			all = ft_strjoin(all, " ");
+		if (count > 1)
+			free(tmp);
+		tmp = all;
+		all = ft_strjoin(all, g_shell.params[count]);
+		free(tmp);
+	}
+	return (all);
+}
@@ -0,0 +1,175 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   glob.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/15 11:40:52 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/15 11:40:52 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static char	*unescape(char *pat, int len)
+{
+	char	*new;
+	int		i;
+	int		j;
+
+	new = malloc(len + 1);
+	i = 0;
+	j = 0;
+	while (i < len)
+	{
+		if (pat[i] == '\\' && i + 1 < len)
+			i++;
+		new[j++] = pat[i++];
+	}
+	new[j] = '\0';
+	return (new);
+}
+
+static char	*join_path(char *base, char *name)
+{
+	char	*tmp;
+	char	*path;
+
+	if (!*base)
+		return (ft_strdup(name));
+	if (base[ft_strlen(base) - 1] == '/')
+		return (ft_strjoin(base, name));
+	tmp = ft_strjoin(base, "/");
+	path = ft_strjoin(tmp, name);
+	free(tmp);
+	return (path);
+}
+
+static int	is_dir(char *base, struct dirent *entry)
+{
+	struct stat	st;
+	char		*path;
+	int			ret;
+
+	if (entry->d_type == DT_DIR)
+		return (1);
+	if (entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK)
+		return (0);
+	path = join_path(base, entry->d_name);
+	ret = (stat(path, &st) == 0 && S_ISDIR(st.st_mode));
+	free(path);
+	return (ret);
+}
+
+static int	has_meta(char *pat, int len)
+{
+	int	i;
+
+	i = 0;
+	while (i < len)
+	{
+		if (pat[i] == '\\')
+			i++;
+		else if (pat[i] == '*' || pat[i] == '?' || pat[i] == '[')
+			return (1);
+		i++;
+	}
+	return (0);
+}
+
+static void	glob_dir(t_args *out, char *base, char *pat);
+
+// One readdir() pass over the directory: names are matched in place
+// and only the matching ones are copied into the result.
+static void	scan_dir(t_args *out, char *base, char *comp, int len)
+{
+	DIR				*dir;
+	struct dirent	*entry;
+	t_glob_op		*ops;
+	int				n;
+	int				last;
+
+	dir = opendir(*base ? base : ".");
+	if (!dir)
+		return ;
+	ops = glob_compile(comp, len, &n);
+	last = (comp[len] == '\0');
+	entry = readdir(dir);
+	while (entry)
+	{
+		if ((entry->d_name[0] != '.' || comp[0] == '.')
+			&& ft_strcmp(entry->d_name, ".") && ft_strcmp(entry->d_name, "..")
+			&& glob_match(ops, n, entry->d_name))
+		{
+			if (last)
+				args_push(out, join_path(base, entry->d_name));
+			else if (is_dir(base, entry))
+				glob_dir(out, join_path(base, entry->d_name), comp + len + 1);
+		}
+		entry = readdir(dir);
+	}
+	free(ops);
+	closedir(dir);
+}
+
+static void	glob_dir(t_args *out, char *base, char *pat)
+{
+	struct stat	st;
+	char		*name;
+	char		*path;
+	int			len;
+
+	while (*pat == '/')
+		pat++;
+	len = 0;
+	while (pat[len] && pat[len] != '/')
+		len++;
+	if (len == 0)
+	{
+		args_push(out, base);
+		return ;
+	}
+	if (has_meta(pat, len))
+		scan_dir(out, base, pat, len);
+	else
+	{
+		name = unescape(pat, len);
+		path = join_path(base, name);
+		free(name);
+		if (!pat[len] && lstat(path, &st) == 0)
+			args_push(out, path);
+		else if (pat[len])
+			glob_dir(out, path, pat + len);
+		else
+			free(path);
+	}
+	free(base);
+}
+
+static int	cmp_names(const void *a, const void *b)
+{
+	return (strcmp(*(char **)a, *(char **)b));
+}
+
+// Expands an unquoted pattern into sorted paths appended to args.
+// Quoted parts arrive backslash-escaped in pat; word is the literal
+// fallback when nothing matches and is freed otherwise.
+int	glob_expand(t_args *args, char *pat, char *word)
+{
+	int	start;
+
+	start = args->len;
+	if (*pat == '/')
+		glob_dir(args, ft_strdup("/"), pat);
+	else
+		glob_dir(args, ft_strdup(""), pat);
+	if (args->len == start)
+	{
+		args_push(args, word);
+		return (0);
+	}
+	free(word);
+	qsort(args->str + start, args->len - start, sizeof(char *), cmp_names);
+	return (args->len - start);
+}
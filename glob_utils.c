@@ -0,0 +1,177 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   glob_utils.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/15 11:02:17 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/15 11:02:17 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+int	has_glob_chars(char *str)
+{
+	int	i;
+
+	i = 0;
+	while (str && str[i])
+	{
+		if (str[i] == '*' || str[i] == '?' || str[i] == '[')
+			return (1);
+		i++;
+	}
+	return (0);
+}
+
+char	*glob_escape(char *str)
+{
+	char	*new;
+	int		i;
+	int		j;
+
+	new = malloc(ft_strlen(str) * 2 + 1);
+	i = 0;
+	j = 0;
+	while (str && str[i])
+	{
+		if (ft_strchr("*?[]\\", str[i]))
+			new[j++] = '\\';
+		new[j++] = str[i++];
+	}
+	new[j] = '\0';
+	return (new);
+}
+
+// [abc], [a-z], [!x] and [^x]; returns the index right after ']'
+// or -1 when the bracket is not closed (then '[' is a plain char)
+static int	compile_class(t_glob_op *op, char *pat, int i, int len)
+{
+	int	neg;
+	int	c;
+	int	k;
+
+	neg = 0;
+	i++;
+	if (i < len && (pat[i] == '!' || pat[i] == '^'))
+	{
+		neg = 1;
+		i++;
+	}
+	memset(op->set, 0, 32);
+	k = i;
+	while (k < len && (pat[k] != ']' || k == i))
+	{
+		if (pat[k] == '\\' && k + 1 < len)
+			k++;
+		c = (unsigned char)pat[k];
+		if (k + 2 < len && pat[k + 1] == '-' && pat[k + 2] != ']')
+		{
+			while (c <= (unsigned char)pat[k + 2])
+			{
+				op->set[c >> 3] |= 1 << (c & 7);
+				c++;
+			}
+			k += 2;
+		}
+		else
+			op->set[c >> 3] |= 1 << (c & 7);
+		k++;
+	}
+	if (k >= len)
+		return (-1);
+	if (neg)
+	{
+		c = -1;
+		while (++c < 32)
+			op->set[c] = ~op->set[c];
+	}
+	op->type = G_CLASS;
+	return (k + 1);
+}
+
+// Compiles one path component once, so matching a directory with many
+// entries does no per-entry parsing or allocation.
+t_glob_op	*glob_compile(char *pat, int len, int *n)
+{
+	t_glob_op	*ops;
+	int			i;
+	int			next;
+
+	ops = malloc(sizeof(t_glob_op) * (len + 1));
+	*n = 0;
+	i = 0;
+	while (i < len)
+	{
+		next = -1;
+		if (pat[i] == '*')
+		{
+			if (!*n || ops[*n - 1].type != G_STAR)
+				ops[(*n)++].type = G_STAR;
+			i++;
+			continue ;
+		}
+		if (pat[i] == '[')
+			next = compile_class(&ops[*n], pat, i, len);
+		if (next != -1)
+		{
+			(*n)++;
+			i = next;
+			continue ;
+		}
+		ops[*n].type = G_CHAR;
+		if (pat[i] == '?')
+			ops[*n].type = G_ANY;
+		if (pat[i] == '\\' && i + 1 < len)
+			i++;
+		ops[(*n)++].c = pat[i++];
+	}
+	return (ops);
+}
+
+static int	match_one(t_glob_op *op, unsigned char c)
+{
+	if (op->type == G_ANY)
+		return (1);
+	if (op->type == G_CHAR)
+		return (op->c == c);
+	return ((op->set[c >> 3] >> (c & 7)) & 1);
+}
+
+// Backtracks only to the last '*', so a name is scanned once per star
+int	glob_match(t_glob_op *ops, int n, char *name)
+{
+	int	p;
+	int	s;
+	int	star_p;
+	int	star_s;
+
+	p = 0;
+	s = 0;
+	star_p = -1;
+	while (name[s])
+	{
+		if (p < n && ops[p].type == G_STAR)
+		{
+			star_p = ++p;
+			star_s = s;
+		}
+		else if (p < n && match_one(&ops[p], name[s]))
+		{
+			p++;
+			s++;
+		}
+		else if (star_p == -1)
+			return (0);
+		else
+		{
+			p = star_p;
+			s = ++star_s;
+		}
+	}
+	while (p < n && ops[p].type == G_STAR)
+		p++;
+	return (p == n);
+}
@@ -0,0 +1,283 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   groups.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/08 10:14:37 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/08 10:14:37 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static t_token_list	*skip_spaces(t_token_list *token)
+{
+	while (token && token->type == SPACE)
+		token = token->next;
+	return (token);
+}
+
+// ( and {, and the loops, can only start a command: a | in front of
+// one ends the simple pipeline before it
+int	is_compound(t_token_list *token)
+{
+	return (token && (token->type == PAREN_OPEN || is_keyword(token, "{")
+			|| is_keyword(token, "for") || is_keyword(token, "while")
+			|| is_keyword(token, "until")));
+}
+
+// Redirections after the closing ), } or done are kept as tokens, to be
+// expanded and opened once for the whole body when it runs
+void	parse_redirections(t_parse *p, t_node *node)
+{
+	t_token_list	head;
+	t_token_list	*last;
+
+	last = &head;
+	head.next = NULL;
+	while (is_redirection(skip_spaces(p->tok)->type))
+	{
+		p->tok = skip_spaces(p->tok);
+		last->next = new_token(p->tok->value, p->tok->type);
+		last = last->next;
+		p->tok = skip_spaces(p->tok->next);
+		while (p->tok->type == WORD || p->tok->type == DOLLAR
+			|| p->tok->type == AFDOLLAR)
+		{
+			last->next = new_token(p->tok->value, p->tok->type);
+			last->next->flags = p->tok->flags;
+			last = last->next;
+			p->tok = p->tok->next;
+		}
+	}
+	if (!head.next)
+		return ;
+	last->next = new_token("N", NLINE);
+	node->tokens = head.next;
+	if (!syntax(node->tokens, &p->err))
+		parse_error(p);
+}
+
+// ( LIST ) runs in a forked subshell, { LIST; } in the shell itself
+t_node	*parse_group(t_parse *p)
+{
+	t_node	*node;
+
+	if (p->tok->type == PAREN_OPEN)
+		node = new_node(N_SUBSHELL);
+	else
+		node = new_node(N_GROUP);
+	p->tok = p->tok->next;
+	if (node->type == N_SUBSHELL)
+		node->body = parse_list(p, ")");
+	else
+		node->body = parse_list(p, "}");
+	if (p->state == P_DONE && !node->body)
+		parse_error(p);
+	if (p->state == P_DONE)
+	{
+		p->tok = p->tok->next;
+		parse_redirections(p, node);
+	}
+	if (p->state == P_DONE)
+		return (node);
+	free_tree(node);
+	return (NULL);
+}
+
+int	at_pipe(t_parse *p)
+{
+	t_token_list	*token;
+
+	token = skip_spaces(p->tok);
+	return (token && token->type == PIPE);
+}
+
+// A pipeline with a group or a loop among its stages; the stages are
+// the body, each one run in a child of its own
+t_node	*parse_pipe(t_parse *p, t_node *first)
+{
+	t_node	*node;
+	t_node	*last;
+
+	node = new_node(N_PIPE);
+	node->body = first;
+	last = first;
+	while (p->state == P_DONE && at_pipe(p))
+	{
+		p->tok = skip_spaces(skip_spaces(p->tok)->next);
+		if (!p->tok || p->tok->type == NLINE || p->tok->type == SEMI
+			|| p->tok->type == PIPE)
+			parse_error(p);
+		else
+			last->next = parse_stage(p);
+		if (!last->next)
+			break ;
+		last = last->next;
+	}
+	if (p->state == P_DONE)
+		return (node);
+	free_tree(node);
+	return (NULL);
+}
+
+// The node's own redirections are opened once, before its body runs
+int	open_redirections(t_node *node, t_cmd_line **redir, int saved[2])
+{
+	int	fd;
+
+	saved[0] = -1;
+	saved[1] = -1;
+	*redir = NULL;
+	if (!node->tokens)
+		return (1);
+	*redir = build_pipeline(node->tokens);
+	if (!*redir)
+		return (1);
+	ft_heredoc(redir, &fd);
+	if (push_redirections(redir, saved))
+		return (1);
+	g_shell.status = 1;
+	return (0);
+}
+
+void	run_group(t_node *node)
+{
+	t_cmd_line	*redir;
+	int			saved[2];
+
+	if (open_redirections(node, &redir, saved))
+		run_list(node->body);
+	close_redirections(redir, saved);
+}
+
+void	close_redirections(t_cmd_line *redir, int saved[2])
+{
+	pop_redirections(saved);
+	free_all(redir);
+}
+
+// With last_line set the last command of the body replaces the child
+// instead of being forked again, so ( cmd ) costs a single fork
+static void	subshell(t_node *node)
+{
+	t_cmd_line	*redir;
+	int			saved[2];
+
+	if (!open_redirections(node, &redir, saved))
+		exit(1);
+	g_shell.last_line = 1;
+	run_list(node->body);
+	exit(g_shell.status);
+}
+
+// On the last line of the input nothing is left to protect from the
+// body's side effects, so the shell itself becomes the subshell
+void	run_subshell(t_node *node)
+{
+	pid_t	pid;
+	int		status;
+	long	start;
+
+	if (g_shell.last_line && !g_shell.timing && !stages_pending())
+		subshell(node);
+	start = trace_now();
+	pid = fork();
+	trace_fork(pid, "subshell", start);
+	if (pid == 0)
+		subshell(node);
+	if (pid > 0 && wait_stage(pid, &status, "subshell") > 0)
+		g_shell.status = exit_code(status);
+}
+
+static char	*node_name(t_node *node)
+{
+	if (node->type == N_PIPELINE && node->tokens)
+		return (node->tokens->value);
+	if (node->type == N_SUBSHELL)
+		return ("subshell");
+	if (node->type == N_GROUP)
+		return ("group");
+	return ("loop");
+}
+
+static void	pipe_stage(t_node *node, int in, int fd[2])
+{
+	if (in != -1)
+	{
+		dup2(in, 0);
+		close(in);
+	}
+	if (fd[1] != -1)
+	{
+		dup2(fd[1], 1);
+		close(fd[1]);
+		close(fd[0]);
+	}
+	node->next = NULL;
+	g_shell.last_line = 1;
+	run_list(node);
+	exit(g_shell.status);
+}
+
+static int	count_stages(t_node *stage)
+{
+	int	n;
+
+	n = 0;
+	while (stage)
+	{
+		n++;
+		stage = stage->next;
+	}
+	return (n);
+}
+
+void	run_pipe(t_node *node)
+{
+	t_node	*stage;
+	pid_t	*pids;
+	int		fd[2];
+	int		in;
+	int		i;
+	int		status;
+	long	start;
+
+	pids = malloc(sizeof(pid_t) * count_stages(node->body));
+	tune_pipeline();
+	in = -1;
+	stage = node->body;
+	i = 0;
+	while (stage)
+	{
+		fd[0] = -1;
+		fd[1] = -1;
+		if (stage->next && !pipe_cloexec(fd))
+			tune_pipe(fd);
+		start = trace_now();
+		pids[i] = fork();
+		trace_fork(pids[i], node_name(stage), start);
+		if (pids[i] == 0)
+			pipe_stage(stage, in, fd);
+		if (in != -1)
+			close(in);
+		if (fd[1] != -1)
+			close(fd[1]);
+		in = fd[0];
+		stage = stage->next;
+		i++;
+	}
+	stage = node->body;
+	i = 0;
+	while (stage)
+	{
+		if (pids[i] > 0 && wait_stage(pids[i], &status, node_name(stage)) > 0
+			&& !stage->next)
+			g_shell.status = exit_code(status);
+		stage = stage->next;
+		i++;
+	}
+	free(pids);
+}
@@ -14,8 +14,8 @@ t_export	*addnew1(char *var, char *value)
 void	addback_export1(t_export **a, t_export *new)
 {
   t_export  *head;
-static int i = 1;
-    if(i++ == 1)
+
+    if (*a == NULL)
     {
         (*a) = new;
     }
@@ -94,6 +94,24 @@ void sort(t_export ** head) {
     
     *head = sorted;
 }
+char    **split_env_entry(char *entry)
+{
+    char    **var_val;
+    int     i;
+
+    var_val = malloc(sizeof(char *) * 3);
+    i = 0;
+    while (entry[i] && entry[i] != '=')
+        i++;
+    var_val[0] = ft_strndup(entry, i);
+    if (entry[i])
+        var_val[1] = ft_strdup(entry + i + 1);
+    else
+        var_val[1] = ft_strdup("");
+    var_val[2] = NULL;
+    return (var_val);
+}
+
 void    init_env(t_export **export,t_env_list **env_list, char *env[])
 {
     int i;
@@ -106,7 +124,7 @@ void    init_env(t_export **export,t_env_list **env_list, char *env[])
     t_env_list *new1;
     while (env[i])
     {
-        var_val = ft_split(env[i],'=');
+        var_val = split_env_entry(env[i]);
         new = addnew1(var_val[0],var_val[1]);
         addback_export1(export, new);
         new1 = addnew2_1(var_val[0],var_val[1]);
@@ -0,0 +1,208 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   input.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/16 10:12:31 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/16 10:12:31 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static t_input	*get_input(void)
+{
+	static t_input	input;
+
+	return (&input);
+}
+
+static int	fill_input(t_input *in)
+{
+	int	n;
+	int	size;
+
+	if (in->eof)
+		return (0);
+	if (in->start > 0)
+	{
+		memmove(in->buf, in->buf + in->start, in->end - in->start);
+		in->end -= in->start;
+		in->start = 0;
+	}
+	if (in->end == INPUT_BUF)
+		return (1);
+	size = INPUT_BUF - in->end;
+	if (in->seekable && size > 4096)
+		size = 4096;
+	n = read(0, in->buf + in->end, size);
+	if (n <= 0)
+	{
+		in->eof = 1;
+		return (0);
+	}
+	in->end += n;
+	return (1);
+}
+
+// Appends the buffered bytes up to the next newline to line; returns 1
+// once the newline has been consumed. A line of any length is built up
+// across refills.
+static int	take_line(t_input *in, t_buf *line)
+{
+	char	*nl;
+	int		n;
+
+	nl = memchr(in->buf + in->start, '\n', in->end - in->start);
+	n = in->end - in->start;
+	if (nl)
+		n = nl - (in->buf + in->start);
+	buf_append(line, in->buf + in->start, n);
+	in->start += n + (nl != NULL);
+	return (nl != NULL);
+}
+
+static void	unread_input(t_input *in)
+{
+	if (in->start < in->end && lseek(0, in->start - in->end, SEEK_CUR) != -1)
+	{
+		in->start = 0;
+		in->end = 0;
+	}
+}
+
+// Heredoc bodies of a sourced script come from its text instead of the
+// shell's input; the end of the text reads as end of file
+static char	*feed_line(t_input *in)
+{
+	char	*nl;
+	char	*line;
+	size_t	n;
+
+	if (!in->feed_len)
+		return (NULL);
+	nl = memchr(in->feed, '\n', in->feed_len);
+	n = in->feed_len;
+	if (nl)
+		n = nl - in->feed;
+	line = ft_strndup(in->feed, n);
+	in->feed += n + (nl != NULL);
+	in->feed_len -= n + (nl != NULL);
+	return (line);
+}
+
+// Swaps the text read_line serves from with *data/*len; NULL data goes
+// back to the shell's input. Calling it again with the same variables
+// restores the previous feed
+void	input_feed(char **data, size_t *len)
+{
+	t_input	*in;
+	char	*data_;
+	size_t	len_;
+
+	in = get_input();
+	data_ = in->feed;
+	len_ = in->feed_len;
+	in->feed = *data;
+	in->feed_len = *len;
+	*data = data_;
+	*len = len_;
+}
+
+// Remembers which file stdin was, so read can tell the script from a
+// redirection later on
+static void	check_input(t_input *in)
+{
+	struct stat	st;
+
+	in->seekable = (lseek(0, 0, SEEK_CUR) != -1);
+	in->checked = 1;
+	if (!fstat(0, &st))
+	{
+		in->dev = st.st_dev;
+		in->ino = st.st_ino;
+	}
+}
+
+// Scripts are read in chunks instead of one byte at a time. On seekable
+// input the offset is moved back to the end of the consumed line so
+// commands reading the same stdin start at the right place.
+char	*read_line(char *prompt)
+{
+	t_input	*in;
+	t_buf	line;
+	int		got;
+
+	in = get_input();
+	if (in->feed)
+		return (feed_line(in));
+	if (g_shell.interactive)
+		return (readline(prompt));
+	if (!in->checked)
+		check_input(in);
+	memset(&line, 0, sizeof(t_buf));
+	buf_grow(&line, 0);
+	got = 0;
+	while (1)
+	{
+		if (in->start == in->end && !fill_input(in))
+			break ;
+		got = 1;
+		if (take_line(in, &line))
+			break ;
+	}
+	if (!got)
+	{
+		free(line.data);
+		return (NULL);
+	}
+	unread_input(in);
+	return (line.data);
+}
+
+// A script piped into the shell has been read ahead of the command
+// running now, so read on that same stdin takes its line from the
+// buffer; 1 when the newline was reached, -1 when fd 0 is anything
+// else (a redirection, another pipe, a seekable file kept in step)
+int	input_take_line(t_buf *line)
+{
+	t_input		*in;
+	struct stat	st;
+
+	in = get_input();
+	if (g_shell.interactive || !in->checked || in->seekable
+		|| fstat(0, &st) || st.st_dev != in->dev || st.st_ino != in->ino)
+		return (-1);
+	while (1)
+	{
+		if (in->start == in->end && !fill_input(in))
+			return (0);
+		if (take_line(in, line))
+			return (1);
+	}
+}
+
+// True when nothing follows the line that was just read. Only a
+// regular file can tell without waiting: on a pipe or a tty the check
+// would block before the line has run, so there the next read_line
+// finds the end instead
+int	input_exhausted(void)
+{
+	t_input		*in;
+	struct stat	st;
+	off_t		pos;
+
+	if (g_shell.interactive)
+		return (0);
+	in = get_input();
+	if (in->start < in->end)
+		return (0);
+	if (in->eof)
+		return (1);
+	if (fstat(0, &st) || !S_ISREG(st.st_mode))
+		return (0);
+	pos = lseek(0, 0, SEEK_CUR);
+	return (pos != -1 && pos >= st.st_size);
+}
@@ -0,0 +1,265 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   libminishell.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/28 15:40:27 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/28 15:40:27 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+#include "libminishell.h"
+
+struct ms_ctx
+{
+	t_shell		shell;
+	t_env_list	*env_list;
+	t_export	*export_list;
+	t_shell		saved;
+};
+
+// The shell keeps its state in g_shell; a call swaps the context's copy
+// in and takes it back out when it returns. The caller's stdio buffers
+// are flushed first or every child the shell forks would flush them too.
+static void	enter(t_ms_ctx *ctx)
+{
+	fflush(NULL);
+	ctx->saved = g_shell;
+	g_shell = ctx->shell;
+	g_shell.env_list = &ctx->env_list;
+	g_shell.export_list = &ctx->export_list;
+}
+
+static void	leave(t_ms_ctx *ctx)
+{
+	ctx->shell = g_shell;
+	g_shell = ctx->saved;
+}
+
+t_ms_ctx	*ms_create(char **envp)
+{
+	t_ms_ctx	*ctx;
+
+	ctx = malloc(sizeof(t_ms_ctx));
+	memset(ctx, 0, sizeof(t_ms_ctx));
+	ctx->shell.embedded = 1;
+	init_env(&ctx->export_list, &ctx->env_list, envp);
+	return (ctx);
+}
+
+// The two lists share their strings per variable; whatever the export
+// entry does not share with the env entry of the same name is its own
+static void	free_export(t_export *export, t_env_list *env_list)
+{
+	t_export	*next;
+	t_env_list	*env;
+
+	while (export)
+	{
+		next = export->next;
+		env = env_list;
+		while (env && ft_strcmp(env->name, export->var))
+			env = env->next;
+		if (!env || env->name != export->var)
+			free(export->var);
+		if (!env || env->value != export->value)
+			free(export->value);
+		free(export);
+		export = next;
+	}
+}
+
+void	ms_destroy(t_ms_ctx *ctx)
+{
+	t_env_list	*env;
+
+	free_export(ctx->export_list, ctx->env_list);
+	while (ctx->env_list)
+	{
+		env = ctx->env_list;
+		ctx->env_list = env->next;
+		free(env->name);
+		free(env->value);
+		free(env);
+	}
+	free(ctx);
+}
+
+void	ms_setenv(t_ms_ctx *ctx, char *name, char *value)
+{
+	enter(ctx);
+	set_env_var(name, value);
+	leave(ctx);
+}
+
+char	*ms_getenv(t_ms_ctx *ctx, char *name)
+{
+	t_env_list	*env;
+
+	env = ctx->env_list;
+	while (env && ft_strcmp(env->name, name))
+		env = env->next;
+	if (!env)
+		return (NULL);
+	return (env->value);
+}
+
+// Nothing is printed: the message goes back to the caller, whose
+// stdout is not ours to write to
+t_ms_node	*ms_parse(t_ms_ctx *ctx, char *line, int *state, const char **err)
+{
+	t_ms_node	*tree;
+	char		*msg;
+
+	enter(ctx);
+	tree = parse_tree(line, state, &msg);
+	leave(ctx);
+	if (err)
+		*err = msg;
+	return (tree);
+}
+
+void	ms_free(t_ms_node *tree)
+{
+	free_tree(tree);
+}
+
+int	ms_node_type(t_ms_node *node)
+{
+	return (node->type);
+}
+
+t_ms_node	*ms_node_next(t_ms_node *node)
+{
+	return (node->next);
+}
+
+t_ms_node	*ms_node_body(t_ms_node *node)
+{
+	return (node->body);
+}
+
+int	ms_stage_count(t_ms_ctx *ctx, t_ms_node *node)
+{
+	t_token_list	*tok;
+	int				count;
+
+	(void)ctx;
+	if (node->type != N_PIPELINE)
+		return (0);
+	count = 1;
+	tok = node->tokens;
+	while (tok)
+	{
+		count += (tok->type == PIPE);
+		tok = tok->next;
+	}
+	return (count);
+}
+
+// The words of one stage as the executor would see them: expansions
+// are done, so a $(...) in the stage does run
+char	**ms_stage_argv(t_ms_ctx *ctx, t_ms_node *node, int stage)
+{
+	t_cmd_line	*cmd_line;
+	t_cmd_line	*cmd;
+	char		**argv;
+	int			i;
+
+	if (node->type != N_PIPELINE)
+		return (NULL);
+	enter(ctx);
+	cmd_line = build_pipeline(node->tokens);
+	procsub_cleanup();
+	leave(ctx);
+	cmd = cmd_line;
+	while (cmd && stage-- > 0)
+		cmd = cmd->next;
+	argv = NULL;
+	if (cmd)
+	{
+		i = 0;
+		while (cmd->str[i])
+			i++;
+		argv = malloc(sizeof(char *) * (i + 1));
+		argv[i] = NULL;
+		while (i-- > 0)
+			argv[i] = ft_strdup(cmd->str[i]);
+	}
+	free_all(cmd_line);
+	return (argv);
+}
+
+void	ms_free_argv(char **argv)
+{
+	if (argv)
+		free_2d(argv);
+}
+
+// The caller's process is never replaced: nothing is tail-exec'd and
+// exec without a command is refused
+int	ms_exec(t_ms_ctx *ctx, t_ms_node *tree, int fds[3])
+{
+	int	saved[3];
+	int	i;
+
+	i = -1;
+	while (++i < 3)
+	{
+		saved[i] = -1;
+		if (fds && fds[i] >= 0 && fds[i] != i)
+		{
+			saved[i] = fcntl(i, F_DUPFD_CLOEXEC, 3);
+			dup2(fds[i], i);
+		}
+	}
+	enter(ctx);
+	g_shell.last_line = 0;
+	run_list(tree);
+	g_shell.breaking = 0;
+	g_shell.continuing = 0;
+	leave(ctx);
+	while (i-- > 0)
+	{
+		if (saved[i] < 0)
+			continue ;
+		dup2(saved[i], i);
+		close(saved[i]);
+	}
+	return (ctx->shell.status);
+}
+
+// A parse error goes to the stderr the command would have had
+static int	run_error(int fds[3], const char *err)
+{
+	int	fd;
+
+	fd = 2;
+	if (fds && fds[2] >= 0)
+		fd = fds[2];
+	if (err)
+	{
+		write(fd, "minishell: ", 11);
+		write(fd, err, ft_strlen((char *)err));
+		write(fd, "\n", 1);
+	}
+	return (2);
+}
+
+int	ms_run(t_ms_ctx *ctx, char *line, int fds[3])
+{
+	t_ms_node	*tree;
+	const char	*err;
+	int			state;
+	int			status;
+
+	tree = ms_parse(ctx, line, &state, &err);
+	if (state != P_DONE)
+		return (run_error(fds, err));
+	status = ms_exec(ctx, tree, fds);
+	ms_free(tree);
+	return (status);
+}
@@ -0,0 +1,59 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   libminishell.h                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/28 15:40:27 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/28 15:40:27 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LIBMINISHELL_H
+#define LIBMINISHELL_H
+
+// Embedding API. A context owns its own environment; the shell itself
+// is not re-entrant, so contexts must be used from one thread at a time.
+
+typedef struct ms_ctx	t_ms_ctx;
+typedef struct node		t_ms_node;
+
+#define MS_PIPELINE 0
+#define MS_FOR 1
+#define MS_WHILE 2
+#define MS_UNTIL 3
+#define MS_FUNCDEF 4
+#define MS_TIME 5
+#define MS_SUBSHELL 6
+#define MS_GROUP 7
+#define MS_PIPE 8
+
+#define MS_DONE 0
+#define MS_INCOMPLETE 1
+#define MS_ERROR 2
+
+t_ms_ctx	*ms_create(char **envp);
+void		ms_destroy(t_ms_ctx *ctx);
+void		ms_setenv(t_ms_ctx *ctx, char *name, char *value);
+char		*ms_getenv(t_ms_ctx *ctx, char *name);
+
+// Parsing never runs anything; state is MS_DONE, MS_INCOMPLETE (an
+// open loop or function) or MS_ERROR, with *err (when err is not NULL)
+// set to the message for an error or to NULL
+t_ms_node	*ms_parse(t_ms_ctx *ctx, char *line, int *state,
+				const char **err);
+void		ms_free(t_ms_node *tree);
+int			ms_node_type(t_ms_node *node);
+t_ms_node	*ms_node_next(t_ms_node *node);
+t_ms_node	*ms_node_body(t_ms_node *node);
+int			ms_stage_count(t_ms_ctx *ctx, t_ms_node *node);
+char		**ms_stage_argv(t_ms_ctx *ctx, t_ms_node *node, int stage);
+void		ms_free_argv(char **argv);
+
+// Runs a tree with fds[0..2] as stdin, stdout and stderr (-1 keeps the
+// caller's) and returns the exit status
+int			ms_exec(t_ms_ctx *ctx, t_ms_node *tree, int fds[3]);
+int			ms_run(t_ms_ctx *ctx, char *line, int fds[3]);
+
+#endif
@@ -0,0 +1,219 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   loops.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/18 14:47:12 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/18 14:47:12 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static int	expect_keyword(t_parse *p, char *word)
+{
+	skip_separators(p);
+	if (p->state != P_DONE)
+		return (0);
+	if (!p->tok || p->tok->type == NLINE)
+	{
+		p->state = P_INCOMPLETE;
+		return (0);
+	}
+	if (!is_keyword(p->tok, word))
+	{
+		parse_error(p);
+		return (0);
+	}
+	p->tok = p->tok->next;
+	return (1);
+}
+
+// for NAME [in WORDS]; do LIST; done
+static int	parse_for_head(t_parse *p, t_node *node)
+{
+	p->tok = p->tok->next;
+	while (p->tok->type == SPACE)
+		p->tok = p->tok->next;
+	if (p->tok->type != WORD || !correct_name(p->tok->value)
+		|| ft_strchr(p->tok->value, '+'))
+	{
+		parse_error(p);
+		return (0);
+	}
+	node->var = ft_strdup(p->tok->value);
+	p->tok = p->tok->next;
+	while (p->tok->type == SPACE)
+		p->tok = p->tok->next;
+	if (is_keyword(p->tok, "in"))
+	{
+		p->tok = p->tok->next;
+		while (p->tok->type == SPACE)
+			p->tok = p->tok->next;
+		node->words = copy_until_separator(p);
+		if (node->words && !syntax(node->words, &p->err))
+			parse_error(p);
+	}
+	return (p->state == P_DONE);
+}
+
+// The body is parsed once here and kept; each iteration only
+// re-expands the pipelines' tokens
+t_node	*parse_loop(t_parse *p)
+{
+	t_node	*node;
+
+	if (is_keyword(p->tok, "for"))
+		node = new_node(N_FOR);
+	else if (is_keyword(p->tok, "while"))
+		node = new_node(N_WHILE);
+	else
+		node = new_node(N_UNTIL);
+	if (node->type == N_FOR)
+		parse_for_head(p, node);
+	else
+	{
+		p->tok = p->tok->next;
+		node->cond = parse_list(p, "do");
+	}
+	if (expect_keyword(p, "do"))
+		node->body = parse_list(p, "done");
+	if (p->state == P_DONE && expect_keyword(p, "done"))
+		parse_redirections(p, node);
+	if (p->state == P_DONE && (node->type == N_FOR || node->cond))
+		return (node);
+	if (p->state == P_DONE)
+		parse_error(p);
+	free_tree(node);
+	return (NULL);
+}
+
+// After a body ran: 1 when the loop has to stop, handling one level
+// of a pending break or continue
+static int	loop_control(void)
+{
+	if (g_shell.breaking)
+	{
+		g_shell.breaking--;
+		return (1);
+	}
+	if (g_shell.continuing)
+	{
+		g_shell.continuing--;
+		return (g_shell.continuing != 0);
+	}
+	return (0);
+}
+
+// Words that look like NAME=value were taken out by the parser as
+// prefix assignments; in the list of a for they are plain words
+static char	**for_words(t_cmd_line *words)
+{
+	t_args	list;
+	int		i;
+
+	if (!words || !words->assigns || !words->assigns[0])
+		return (NULL);
+	args_init(&list);
+	i = 0;
+	while (words->assigns[i])
+		args_push(&list, words->assigns[i++]);
+	i = 0;
+	while (words->str[i])
+		args_push(&list, words->str[i++]);
+	return (list.str);
+}
+
+static void	run_for(t_node *node)
+{
+	t_cmd_line	*words;
+	char		**list;
+	int			i;
+
+	words = NULL;
+	if (node->words)
+		words = build_pipeline(node->words);
+	else if (g_shell.params)
+		words = init_cmdline(g_shell.params + 1, NULL, NULL);
+	list = for_words(words);
+	if (!list && words)
+		list = words->str;
+	i = 0;
+	g_shell.status = 0;
+	while (list && list[i])
+	{
+		set_env_var(node->var, list[i++]);
+		run_list(node->body);
+		if (loop_control())
+			break ;
+	}
+}
+
+void	run_loop(t_node *node)
+{
+	t_cmd_line	*redir;
+	int			saved[2];
+	int			status;
+
+	if (!open_redirections(node, &redir, saved))
+	{
+		close_redirections(redir, saved);
+		return ;
+	}
+	g_shell.loop_depth++;
+	if (node->type == N_FOR)
+		run_for(node);
+	else
+	{
+		status = 0;
+		while (1)
+		{
+			run_list(node->cond);
+			if (loop_control()
+				|| (g_shell.status == 0) != (node->type == N_WHILE))
+				break ;
+			run_list(node->body);
+			status = g_shell.status;
+			if (loop_control())
+				break ;
+		}
+		g_shell.status = status;
+	}
+	g_shell.loop_depth--;
+	close_redirections(redir, saved);
+}
+
+// break [n] / continue [n]: n loops are left, or skipped to their next
+// iteration, once control gets back to them
+int	ft_break(char **str)
+{
+	int	n;
+	int	i;
+
+	n = 1;
+	if (str[1])
+	{
+		n = 0;
+		i = 0;
+		while (str[1][i] >= '0' && str[1][i] <= '9')
+			n = n * 10 + (str[1][i++] - '0');
+		if (str[1][i] || n < 1)
+		{
+			write(2, "minishell: ", 11);
+			write(2, str[0], ft_strlen(str[0]));
+			write(2, ": numeric argument required\n", 28);
+			return (1);
+		}
+	}
+	if (!g_shell.loop_depth)
+		return (0);
+	if (n > g_shell.loop_depth)
+		n = g_shell.loop_depth;
+	if (!ft_strcmp(str[0], "break"))
+		g_shell.breaking = n;
+	else
+		g_shell.continuing = n;
+	return (0);
+}
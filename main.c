@@ -0,0 +1,44 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   main.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/28 14:02:51 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/28 14:02:51 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+int main(int ac, char **av, char **env)
+{
+	t_node			*tree;
+	t_export    	*export_list;
+	t_env_list		*env_list;
+	long			start;
+
+	if (ac >= 2 && !ft_strcmp(av[1], "--check"))
+		return (check_files(av + 2));
+	export_list = NULL;
+	env_list = NULL;
+	init_env(&export_list, &env_list, env);
+	g_shell.interactive = isatty(0);
+	g_shell.env_list = &env_list;
+	g_shell.export_list = &export_list;
+	if (ac == 3 && !ft_strcmp(av[1], "--serve"))
+		serve(av[2]);
+	init_completion(&env_list);
+	trace_init();
+	fd_check_init();
+    while (1)
+    {
+		tree = read_command();
+		start = trace_now();
+		run_list(tree);
+		trace_span("run", start);
+		free_tree(tree);
+		fd_check();
+    }
+}
\ No newline at end of file
@@ -12,6 +12,8 @@
 
 #include "minishell.h"
 
+t_shell	g_shell;
+
 void	free_all(t_cmd_line *cmd_line)
 {
 	t_cmd_line	*curr;
@@ -28,84 +30,121 @@ void	free_all(t_cmd_line *cmd_line)
 
 void	body(char *line, char **env,t_export **export_list,t_env_list **env_list)
 {
-	t_token_list	*tokens;
-	t_cmd_line		*cmd_line;
-	t_tools			tools;
+	t_node	*tree;
+	int		state;
 
-	cmd_line = NULL;
-	tokens = tokenizer(line, &tools);
-	if (tokens && syntax(tokens))
-	{
-		// env_vars_list(&env_list, env);
-		expand(&tokens, env_list);
-		parser(&cmd_line, tokens);
-		execution(&cmd_line, env_list,export_list);
-	}
-		//////////////////////////////////////////////
-		// int j = 0;
-		// while (cmd_line && cmd_line->str[j])
-		// 	printf("|%s|\n", cmd_line->str[j++]);
-		// if (cmd_line->redirections)
-		// {
-		// 	while (cmd_line->redirections)
-		// 	{
-		// 		printf("%d %s\n", cmd_line->redirections->type, cmd_line->redirections->file);
-		// 		cmd_line->redirections = cmd_line->redirections->next;
-		// 	}
-		// }
-		// puts("--------");
-		// if (cmd_line)
-		// 	printf("%d\n", cmd_line->separator);
-		// puts("--------");
-		// if (cmd_line && cmd_line->next)
-		// {
-		// 	int j = 0;
-		// 	while (cmd_line->next->str[j])
-		// 	printf("%s\n", cmd_line->next->str[j++]);
-		// 	if (cmd_line->next->redirections)
-		// 		printf("%d %s\n", cmd_line->next->redirections->type, cmd_line->next->redirections->file);
-
-		// }
-		///////////////////////////////////////////////
-
-	// while (tokens)
-	// {
-	// 	printf("|%s| ", tokens->value);
-	// 	printf("|%d|\n", tokens->type);
-	// 	tokens = tokens->next;
-	// }
+	tree = parse_input(line, &state);
+	if (state == P_INCOMPLETE)
+		write(1, "parse error\n", ft_strlen("parse error\n"));
+	if (state != P_DONE)
+		g_shell.status = 2;
+	run_list(tree);
+	free_tree(tree);
+}
+
+// "exit" alone on the line, blanks around it allowed
+static int	is_exit(char *line)
+{
+	t_scan	scan;
+	size_t	start;
+	size_t	end;
+	int		ret;
+
+	scan_line(&scan, line);
+	start = scan_skip_blanks(&scan, 0);
+	end = scan_word_end(&scan, start);
+	ret = (end - start == 4 && !ft_strncmp(line + start, "exit", 4)
+			&& scan_skip_blanks(&scan, end) == scan.len);
+	scan_free(&scan);
+	return (ret);
 }
 
 char    *prompt(void)
 {
     char	*line;
 
-	line = readline("\x1B[36m""minishell$ ""\001\e[0m\002");
+	line = read_line("\x1B[36m""minishell$ ""\001\e[0m\002");
 	if (!line)
-		exit(0);
-	add_history(line);
-	line = remove_additional_spaces(line);
+		exit(g_shell.status);
     return (line);
 }
 
-int main(int ac, char **av, char **env)
+// Unlike a script, input read here is parsed again after every line,
+// so an error is reported on the line that made it; only the tokens
+// of the earlier lines are kept
+static t_node	*parse_line(t_pending *pend, char *line, int *state)
 {
-	(void)ac;
-	(void)av;
+	t_node	*tree;
+	char	*err;
+	long	start;
 
-    char	*line;
-	t_export    	*export_list;
-	t_env_list		*env_list;
-
-	export_list = NULL;
-	env_list = NULL;
-	init_env(&export_list, &env_list, env);
-    while (1)
-    {
-		line = prompt();
-		if (!ft_strcmp(line, "exit"))
-			exit(0);
-		if (line)
-			body(line, env,&export_list,&env_list);
-    }
-}
\ No newline at end of file
+	start = trace_now();
+	tree = parse_lines(pend, line, state, &err);
+	trace_span("parse", start);
+	if (*state == P_ERROR && err)
+	{
+		write(1, err, ft_strlen(err));
+		write(1, "\n", 1);
+	}
+	return (tree);
+}
+
+static char	*first_line(void)
+{
+	char	*line;
+	long	start;
+
+	start = trace_now();
+	line = prompt();
+	trace_span("read", start);
+	if (is_exit(line))
+		exit(g_shell.status);
+	return (line);
+}
+
+// Keeps reading "> " lines while a loop is left open
+static t_node	*read_more(t_pending *pend, t_buf *text, t_node *tree,
+	int *state)
+{
+	char	*line;
+
+	while (*state == P_INCOMPLETE)
+	{
+		line = read_line("> ");
+		if (!line)
+		{
+			write(2, "minishell: unexpected end of file\n", 34);
+			break ;
+		}
+		buf_append(text, "\n", 1);
+		buf_append(text, line, ft_strlen(line));
+		tree = parse_line(pend, line, state);
+		free(line);
+	}
+	return (tree);
+}
+
+t_node	*read_command(void)
+{
+	t_pending	pend;
+	t_buf		text;
+	t_node		*tree;
+	char		*line;
+	int			state;
+
+	line = first_line();
+	memset(&pend, 0, sizeof(t_pending));
+	memset(&text, 0, sizeof(t_buf));
+	buf_append(&text, line, ft_strlen(line));
+	tree = parse_line(&pend, line, &state);
+	free(line);
+	tree = read_more(&pend, &text, tree, &state);
+	pending_clear(&pend);
+	if (state != P_DONE)
+		g_shell.status = 2;
+	if (g_shell.interactive && text.len)
+		add_history(text.data);
+	g_shell.last_line = input_exhausted();
+	free(text.data);
+	return (tree);
+}
@@ -8,6 +8,12 @@
 #include <signal.h>
 #include <string.h>
 #include <fcntl.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
 #include <readline/readline.h>
 # include <readline/history.h>
 
@@ -24,13 +30,46 @@
 #define WORD 9
 #define AFDOLLAR 10
 #define NLINE 11
+#define PROCSUB_IN 12
+#define PROCSUB_OUT 13
+#define CMDSUB 14
+#define ARITH 15
+#define SEMI 16
+#define PAREN_OPEN 17
+#define PAREN_CLOSE 18
+
+#define T_GLOB 1
+#define T_SPLIT 2
+#define T_QUOTED 4
+#define T_EOL 8
+
+#define N_PIPELINE 0
+#define N_FOR 1
+#define N_WHILE 2
+#define N_UNTIL 3
+#define N_FUNCDEF 4
+#define N_TIME 5
+#define N_SUBSHELL 6
+#define N_GROUP 7
+#define N_PIPE 8
+
+#define P_DONE 0
+#define P_INCOMPLETE 1
+#define P_ERROR 2
+
+#define G_CHAR 0
+#define G_ANY 1
+#define G_STAR 2
+#define G_CLASS 3
 
 typedef struct line
 {
     char        *value;
     int         type;
+    int         flags;
     struct line *next;
     struct line *prev;
+    struct line *last;
 }t_token_list;
 
 typedef struct redirections
@@ -50,11 +89,49 @@ typedef enum sep
 typedef struct cmd_line
 {
     char            **str;
+    char            **assigns;
     t_redirections  *redirections;
     t_sep			separator;
     struct cmd_line *next;
 }t_cmd_line;
 ///
+typedef struct node
+{
+    int             type;
+    t_token_list    *tokens;
+    char            *var;
+    t_token_list    *words;
+    struct node     *cond;
+    struct node     *body;
+    struct node     *next;
+    int             opts;
+}t_node;
+
+typedef struct func
+{
+    char            *name;
+    t_node          *body;
+    struct func     *next;
+}t_func;
+
+typedef struct parse
+{
+    t_token_list    *tok;
+    int             state;
+    char            *err;
+    t_token_list    *at;
+}t_parse;
+
+// A command read line by line: the tokens so far, how many lines they
+// came from and, after a P_ERROR, which of them (from 0) it is on
+typedef struct pending
+{
+	t_token_list	*tokens;
+	int				lines;
+	int				lazy;
+	int				err_line;
+}t_pending;
+
 typedef	struct env_list
 {
 	char			*name;
@@ -69,15 +146,165 @@ typedef struct  t_export
     
 }t_export;
 
+typedef struct args
+{
+    char    **str;
+    int     len;
+    int     cap;
+    char    *word;
+    char    *pat;
+    int     has_glob;
+    int     assign;
+    struct args *env;
+}t_args;
+
+typedef struct glob_op
+{
+    int             type;
+    unsigned char   c;
+    unsigned char   set[32];
+}t_glob_op;
+
+typedef struct trie
+{
+    char            c;
+    int             count;
+    int             end;
+    struct trie     *child;
+    struct trie     *next;
+}t_trie;
+
+typedef struct path_dir
+{
+    char            *path;
+    struct timespec mtime;
+    char            **names;
+    int             seen;
+    struct path_dir *next;
+}t_path_dir;
+
+typedef struct completion
+{
+    t_trie          root;
+    t_path_dir      *dirs;
+    t_env_list      **env_list;
+    char            **matches;
+    int             index;
+}t_completion;
+
+#define READ_CHUNK 4096
+#define INPUT_BUF 65536
+
+typedef struct input
+{
+    char    buf[INPUT_BUF];
+    int     start;
+    int     end;
+    int     eof;
+    int     seekable;
+    int     checked;
+    dev_t   dev;
+    ino_t   ino;
+    char    *feed;
+    size_t  feed_len;
+}t_input;
+
+typedef struct buf
+{
+    char    *data;
+    size_t  len;
+    size_t  cap;
+}t_buf;
+
+typedef struct stage_usage
+{
+    char                *name;
+    struct rusage       usage;
+    struct stage_usage  *next;
+}t_stage_usage;
+
+typedef struct timing
+{
+    t_stage_usage   *stages;
+    t_stage_usage   *last;
+}t_timing;
+
+typedef struct trace_child
+{
+    pid_t               pid;
+    long                start;
+    char                *name;
+    struct trace_child  *next;
+}t_trace_child;
+
+typedef struct trace
+{
+    int             fd;
+    pid_t           pid;
+    t_trace_child   *children;
+}t_trace;
+
+typedef struct shell
+{
+    t_buf       *capture;
+    int         status;
+    int         interactive;
+    int         last_line;
+    int         loop_depth;
+    int         breaking;
+    int         continuing;
+    t_func      *functions;
+    char        **params;
+    t_timing    *timing;
+    int         embedded;
+    t_env_list  **env_list;
+    t_export    **export_list;
+}t_shell;
+
+extern t_shell  g_shell;
+
+typedef struct scan
+{
+    char        *line;
+    size_t      len;
+    uint64_t    *blank;
+    uint64_t    *special;
+}t_scan;
+
 typedef struct tools
 {
     int there_is_dollar;
     int s_quote;
     int d_quote;
     int no_expand;
-    int dollar_in;
+    int paren;
+    char    *err;
+    t_scan  scan;
 }t_tools;
 
+typedef struct arith
+{
+    char    *s;
+    int     pos;
+    int     skip;
+    char    *err;
+}t_arith;
+
+typedef struct test
+{
+    char    **av;
+    int     ac;
+    int     pos;
+    int     err;
+}t_test;
+
+typedef struct procsub
+{
+    int             fd;
+    pid_t           pid;
+    struct procsub  *next;
+}t_procsub;
+
 typedef struct exec_tools
 {
     t_cmd_line		*cmd_tmp;
@@ -90,29 +317,310 @@ typedef struct exec_tools
     int				heredoc_fd;
 }t_exec_tools;
 
+void			init_env(t_export **export, t_env_list **env_list, char *env[]);
+void			body(char *line, char **env, t_export **export_list, t_env_list **env_list);
+
+
+// Buffers
+void			buf_grow(t_buf *buf, size_t extra);
+void			buf_append(t_buf *buf, char *data, size_t len);
+void			buf_read_fd(t_buf *buf, int fd);
+
+// In-process pipeline stages
+int				runs_as_stage(t_cmd_line *cmd);
+void			capture_stage(char **str, t_buf *buf);
+void			run_stage(t_cmd_line *cmd, int fd);
+int				stages_pending(void);
+void			close_stage_fds(void);
+void			wait_stages(void);
+
+// parallel
+typedef struct job
+{
+	pid_t	pid;
+	int		fd;
+	int		status;
+	t_buf	out;
+}t_job;
+
+typedef struct parallel
+{
+	char	**tmpl;
+	int		len;
+	int		jobs;
+	int		count;
+	int		launched;
+	int		printed;
+	int		running;
+	char	*path;
+	char	**envp;
+	t_job	*job;
+}t_parallel;
+
+int				ft_parallel(char **str);
+
+// fanout
+typedef struct fan
+{
+	int		pipe[2];
+	int		stage[2];
+	size_t	left;
+	pid_t	pid;
+}t_fan;
+
+typedef struct fanout
+{
+	t_fan	*fans;
+	int		n;
+	int		src;
+	int		feed;
+	ssize_t	chunk;
+}t_fanout;
+
+int				ft_fanout(char **argv);
+
+// source
+typedef struct sourced_cmd
+{
+	t_node				*tree;
+	char				*feed;
+	size_t				feed_len;
+	struct sourced_cmd	*next;
+}t_sourced_cmd;
+
+typedef struct sourced
+{
+	dev_t			dev;
+	ino_t			ino;
+	struct timespec	mtime;
+	off_t			size;
+	char			*data;
+	t_sourced_cmd	*cmds;
+	int				busy;
+	int				stale;
+	struct sourced	*next;
+}t_sourced;
+
+int				ft_source(char **argv);
+
+// Command substitution
+char			*cmdsub_capture(char *line);
+
+// Arithmetic
+char			*arith_expand(char *expr);
+
+// Line scanning
+void			scan_line(t_scan *scan, char *line);
+void			scan_free(t_scan *scan);
+size_t			scan_skip_blanks(t_scan *scan, size_t pos);
+size_t			scan_word_end(t_scan *scan, size_t pos);
+
+// Input
+char			*read_line(char *prompt);
+void			input_feed(char **data, size_t *len);
+int				input_exhausted(void);
+int				input_take_line(t_buf *line);
+
 // Tokenizer Utils
 t_token_list    *tokenizer(char *line, t_tools *tools);
 char			*is_redirections(t_token_list **tokens, char *line, t_tools *tools);
-char			*is_wspace(t_token_list **tokens, char *line);
+char			*is_wspace(t_token_list **tokens, char *line, t_tools *tools);
 char			*is_dollar_pipe(t_token_list **tokens, char *line);
-char			*is_word(t_token_list **tokens, char *line);
+char			*is_word(t_token_list **tokens, char *line, t_tools *tools);
 char			*is_squote(t_token_list **tokens, char *line, t_tools *tools);
-char			*is_dquote(t_token_list **tokens, char *line, t_tools *tools);
+char			*is_dquote(t_token_list **tokens, char *line);
 char			*afdollar(t_token_list **tokens, char *line);
 char			*is_space(t_token_list **tokens, char *line);
 char			*ft_dquotes(t_token_list **tokens, char *line, t_tools *tools);
 char            *no_expand(t_token_list **tokens, char	*line, t_tools *tools);
-void	open_quote_error(t_token_list **tokens);
+void            mark_last_token(t_token_list **tokens, int flag);
+void	open_quote_error(t_token_list **tokens, t_tools *tools);
+void	open_paren_error(t_token_list **tokens, t_tools *tools);
+int		match_paren(char *line);
+char	*is_procsub(t_token_list **tokens, char *line, t_tools *tools);
+char	*is_cmdsub(t_token_list **tokens, char *line, t_tools *tools);
+char	*is_backtick(t_token_list **tokens, char *line, t_tools *tools);
+
+// Process substitution
+char	*procsub_spawn(char *cmd, int type);
+void	procsub_cleanup(void);
 
 
+// Completion
+void			init_completion(t_env_list **env_list);
+void			refresh_path_trie(t_completion *comp);
+void			trie_insert(t_trie *root, char *s);
+void			trie_remove(t_trie *root, char *s);
+char			**trie_collect(t_trie *root, char *prefix);
+
 // Expander
 void	        expand(t_token_list **tokens, t_env_list **env);
 t_env_list	    *add_var(char *name, char *value);
 void	        fill_env_list(t_env_list **env_list, t_env_list *new);
 void	        env_vars_list(t_env_list **env_list, char **env);
+char            **split_env_entry(char *entry);
 
 // Syntax
-int	            syntax(t_token_list *tokens);
+int	            syntax(t_token_list *tokens, char **err);
+
+// Command lists and loops
+t_node			*parse_input(char *line, int *state);
+t_node			*parse_tree(char *line, int *state, char **err);
+t_node			*parse_lines(t_pending *pend, char *line, int *state,
+					char **err);
+void			pending_clear(t_pending *pend);
+void			parse_error(t_parse *p);
+t_node			*parse_list(t_parse *p, char *stop);
+t_node			*parse_loop(t_parse *p);
+t_node			*new_node(int type);
+int				is_keyword(t_token_list *token, char *word);
+void			skip_separators(t_parse *p);
+t_token_list	*copy_until_separator(t_parse *p);
+t_token_list	*copy_tokens(t_token_list *tokens);
+void			free_tree(t_node *node);
+void			run_list(t_node *node);
+void			run_pipeline(t_token_list *tokens);
+void			run_loop(t_node *node);
+t_cmd_line		*build_pipeline(t_token_list *tokens);
+void			set_env_var(char *name, char *value);
+int				ft_break(char **str);
+
+// Functions
+int				is_funcdef(t_token_list *token);
+t_node			*parse_function(t_parse *p);
+t_node			*copy_tree(t_node *node);
+void			define_function(t_node *node);
+t_func			*find_function(char *name);
+void			call_function(t_func *func, char **argv);
+void			run_function(t_cmd_line **cmd_line);
+int				is_positional(char *name);
+char			*positional(char *name);
+int				push_redirections(t_cmd_line **cmd_line, int saved[2]);
+void			pop_redirections(int saved[2]);
+
+// Groups
+int				is_compound(t_token_list *token);
+int				at_pipe(t_parse *p);
+t_node			*parse_group(t_parse *p);
+void			parse_redirections(t_parse *p, t_node *node);
+int				open_redirections(t_node *node, t_cmd_line **redir, int saved[2]);
+void			close_redirections(t_cmd_line *redir, int saved[2]);
+t_node			*parse_pipe(t_parse *p, t_node *first);
+void			run_group(t_node *node);
+void			run_subshell(t_node *node);
+void			run_pipe(t_node *node);
+
+// time
+t_node			*parse_command(t_parse *p);
+t_node			*parse_stage(t_parse *p);
+t_node			*parse_time(t_parse *p);
+void			run_timed(t_node *node);
+pid_t			wait_stage(pid_t pid, int *status, char *name);
+
+// fd hygiene
+#define FDCHECK_MAX 1024
+
+typedef struct fdcheck
+{
+	int	enabled;
+	int	first;
+	int	last;
+}t_fdcheck;
+
+int				pipe_cloexec(int fd[2]);
+void			fd_check_init(void);
+void			fd_check(void);
+
+// Pipeline tuning
+#define TUNE_MAX_CPUS 1024
+#define PIN_OFF 0
+#define PIN_SIBLINGS 1
+#define PIN_CORES 2
+
+typedef struct cpu_place
+{
+	int	cpu;
+	int	package;
+	int	core;
+	int	thread;
+}t_cpu_place;
+
+typedef struct tuning
+{
+	int			pipe_size;
+	int			pin;
+	int			policy;
+	int			ncpus;
+	t_cpu_place	places[TUNE_MAX_CPUS];
+}t_tuning;
+
+void			tune_pipeline(void);
+void			tune_pipe(int fd[2]);
+void			tune_stage(int i);
+
+// Server mode
+#define SERVE_MAX_FRAME 16777216
+#define SERVE_MAX_ENV 256
+
+typedef struct request
+{
+	int		fd;
+	char	*cwd;
+	char	*line;
+	char	*env[SERVE_MAX_ENV];
+	int		nenv;
+}t_request;
+
+void			serve(char *path);
+
+// Check mode
+typedef struct deque
+{
+	pthread_mutex_t	lock;
+	int				*items;
+	int				top;
+	int				bottom;
+}t_deque;
+
+typedef struct check
+{
+	char	**files;
+	t_buf	*out;
+	t_deque	*queues;
+	int		nthreads;
+}t_check;
+
+typedef struct worker
+{
+	t_check		*check;
+	int			id;
+	pthread_t	tid;
+}t_worker;
+
+typedef struct script
+{
+	char	*path;
+	char	*pos;
+	char	*end;
+	int		line;
+	int		err_line;
+	t_buf	*out;
+}t_script;
+
+int				check_files(char **files);
+void			script_error(t_script *s, char *msg);
+char			*script_line(t_script *s);
+void			script_heredocs(t_script *s, t_node *node);
+t_node			*script_command(t_script *s, char *line, int *state, char **err);
+void			script_report(t_script *s, int state, char *err);
+
+// Tracing
+void			trace_init(void);
+long			trace_now(void);
+void			trace_span(char *name, long start);
+void			trace_instant(char *name);
+void			trace_fork(pid_t pid, char *name, long start);
+void			trace_reap(pid_t pid);
 
 // Parser
 void			*parser(t_cmd_line **cmd_line, t_token_list *tokens);
@@ -121,13 +629,29 @@ void			fill_redirections_list(t_redirections **redirections, t_redirections *new
 void			separator(t_cmd_line *cmd, t_token_list *token);
 t_cmd_line		*init_cmdline(char **str, t_redirections *redirections, t_token_list *token);
 void			fill_cmd_line(t_cmd_line **cmdline, t_cmd_line *new);
-int				to_alloc_count(t_token_list **tokens);
+int				is_redirection(int type);
+int				is_assignment(t_token_list *token);
+void			append_word(t_args *args, char *value, int glob);
+void			split_word(t_args *args, char *value);
+t_token_list	*add_word(t_args *args, t_token_list *tokens);
+t_token_list	*add_redirection(t_redirections **redirections, t_token_list *tokens);
+void			args_init(t_args *args);
+void			args_push(t_args *args, char *str);
+void			args_flush(t_args *args);
+
+// Glob
+int				has_glob_chars(char *str);
+char			*glob_escape(char *str);
+int				glob_expand(t_args *args, char *pat, char *word);
+t_glob_op		*glob_compile(char *pat, int len, int *n);
+int				glob_match(t_glob_op *ops, int n, char *name);
 
 // Execution
 void execution(t_cmd_line **cmd_line, t_env_list **env_list,t_export **export_list);
 int     main_builtins(t_cmd_line **cmd_line);
 void    execute_builtins(t_cmd_line **cmd_line, t_env_list **env_list,t_export **export_list);
 int	    builtins(char	*cmd);
+int     builtin_code(char **str);
 void	exec_builtins(char	**str, t_env_list **env_list, int code, t_export **export);
 
 char    *get_home_var(t_env_list **env_list);
@@ -135,6 +659,12 @@ char	**get_path(t_env_list **env_list);
 int     count_list(t_cmd_line **cmd_line);
 int     count_envlist(t_env_list **env_list);
 char    **create_envp(t_env_list **env_list);
+char	**overlay_envp(t_env_list **env_list, char **overlay);
+char	*overlay_get(char **overlay, char *name);
+void	set_assignments(char **assigns);
+char	**push_assignments(char **assigns);
+void	pop_assignments(char **assigns, char **saved);
+int     exit_code(int status);
 
 
 void			ft_cd(char *path, t_env_list **env_list);
@@ -147,10 +677,33 @@ void			dup_infile(t_redirections *redirection);
 void			close_pipes(int **fd, int i, int cmds, int flag);
 void    		ft_heredoc(t_cmd_line **cmd_line, int *fd);
 void			execute_command_2(t_cmd_line **cmd_line, t_env_list **env_list,t_export **export);
-void			execve_func(char **cmd, t_env_list **env_list);
+void			execve_func(char **cmd, t_env_list **env_list, char **overlay);
+void			ft_exec(t_cmd_line **cmd_line, t_env_list **env_list);
+int				can_tail_exec(t_cmd_line *cmd);
+void			run_redirected(t_cmd_line **cmd_line, int (*builtin)(char **));
 char            *check_command_in_path(char **path, char *cmd);
 
+// Export
+t_export	*addnew(char *var, char *value);
+t_env_list	*addnew2(char *var, char *value);
+void		addback_env(t_env_list **a, t_env_list *new);
+void		insert(t_export **head, t_export *new_node);
+int			check_if_in_env(char *name, char *value, t_export *env);
+void		edit_value(char *name, char *value, t_export **data, t_env_list **env_list);
+int			correct_name(char *s);
+
+void	free_all(t_cmd_line *cmd_line);
+t_node	*read_command(void);
 void    ft_echo(char **str);
+void    print_env(t_env_list *list);
+void    do_export(char *str[], t_export **data, t_env_list **env_list);
+void    do_unset(char *str[], t_export **data, t_env_list **env_list);
+void	removeNode(t_export **export, char *str);
+void	removeNode2(t_env_list **env, char *str);
+int     ft_test(char **str);
+int     ft_cat(char **str);
+int     cat_options(char **str);
+int     ft_read(char **argv);
 
 void	ft_putstr(char	*str);
 void	free_2d(char **str);
@@ -159,11 +712,7 @@ int is_open_quote(char *line, char quote);
 int     ft_strcmp(char *s1, char *s2);
 int	ft_strncmp(const char *str1, const char *str2, size_t n);
 int     ft_strlen(char *str);
-int		count(char *line);
 int		inside_quotes(char *line, int i);
-int     all_spaces(char *line, int i);
-char    *skip_wspaces(char *line);
-char    *remove_additional_spaces(char *line);
 char	*ft_strchr(char *str, int c);
 void	ft_lstclear(t_token_list	**lst);
 void    addback(t_token_list **tokens, char *value, int type);
@@ -171,6 +720,7 @@ char	*ft_strjoin(char *s1, char *s2);
 char	**ft_split(char const *s, char c);
 t_token_list *new_token(char *value, int type);
 char	*ft_itoa(int n);
+int		ft_atoi(char *str);
 char	*ft_strdup(char *src);
 char	*ft_strndup(char *src, int len);
 
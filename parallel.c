@@ -0,0 +1,281 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parallel.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/22 15:06:31 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/22 15:06:31 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+#include <poll.h>
+
+static char	*fill_word(char *word, char *arg)
+{
+	t_buf	buf;
+	char	*at;
+
+	memset(&buf, 0, sizeof(t_buf));
+	buf_grow(&buf, 0);
+	at = strstr(word, "{}");
+	while (at)
+	{
+		buf_append(&buf, word, at - word);
+		buf_append(&buf, arg, ft_strlen(arg));
+		word = at + 2;
+		at = strstr(word, "{}");
+	}
+	buf_append(&buf, word, ft_strlen(word));
+	return (buf.data);
+}
+
+// Every {} in the template becomes the argument; a template without {}
+// gets the argument as its last word
+static char	**fill_template(char **tmpl, int len, char *arg)
+{
+	char	**argv;
+	int		i;
+	int		used;
+
+	argv = malloc(sizeof(char *) * (len + 2));
+	used = 0;
+	i = -1;
+	while (++i < len)
+	{
+		used |= (strstr(tmpl[i], "{}") != NULL);
+		argv[i] = fill_word(tmpl[i], arg);
+	}
+	if (!used)
+		argv[i++] = ft_strdup(arg);
+	argv[i] = NULL;
+	return (argv);
+}
+
+// One argument per line of standard input, split in place
+static char	**stdin_args(t_buf *in, int *count)
+{
+	char	**args;
+	size_t	i;
+
+	memset(in, 0, sizeof(t_buf));
+	buf_read_fd(in, 0);
+	args = malloc(sizeof(char *) * (in->len + 1));
+	*count = 0;
+	i = 0;
+	while (i < in->len)
+	{
+		args[(*count)++] = in->data + i;
+		while (i < in->len && in->data[i] != '\n')
+			i++;
+		in->data[i++] = '\0';
+	}
+	args[*count] = NULL;
+	return (args);
+}
+
+// The command is looked up and the environment built once, in the
+// shell, so each job is a bare fork and execve
+static void	launch(t_parallel *par, t_job *job, char *arg)
+{
+	int			fd[2];
+	char		**argv;
+	t_cmd_line	*cmd;
+
+	argv = fill_template(par->tmpl, par->len, arg);
+	job->fd = -1;
+	job->status = 1;
+	if (pipe_cloexec(fd) == -1)
+		return ;
+	job->pid = fork();
+	if (!job->pid)
+	{
+		dup2(fd[1], 1);
+		close(fd[1]);
+		if (par->path && !find_function(argv[0]) && !builtin_code(argv))
+		{
+			trace_instant("exec");
+			execve(par->path, argv, par->envp);
+		}
+		cmd = init_cmdline(argv, NULL, NULL);
+		execute_command_2(&cmd, g_shell.env_list, g_shell.export_list);
+		exit(g_shell.status);
+	}
+	close(fd[1]);
+	free_2d(argv);
+	if (job->pid < 0)
+		close(fd[0]);
+	else
+		job->fd = fd[0];
+	par->running += (job->pid > 0);
+}
+
+static void	emit(t_buf *out)
+{
+	size_t	done;
+	ssize_t	n;
+
+	if (g_shell.capture)
+		buf_append(g_shell.capture, out->data, out->len);
+	done = 0;
+	while (!g_shell.capture && done < out->len)
+	{
+		n = write(1, out->data + done, out->len - done);
+		if (n <= 0)
+			break ;
+		done += n;
+	}
+	free(out->data);
+	out->data = NULL;
+}
+
+// Reads whatever the running jobs have written, then reaps the ones
+// whose output is closed without ever blocking in waitpid
+static void	collect(t_parallel *par)
+{
+	struct pollfd	pfd[par->jobs];
+	t_job			*job[par->jobs];
+	int				n;
+	int				i;
+	int				status;
+	int				waiting;
+
+	n = 0;
+	waiting = 0;
+	i = par->printed - 1;
+	while (++i < par->launched)
+	{
+		if (par->job[i].fd >= 0)
+		{
+			pfd[n].fd = par->job[i].fd;
+			pfd[n].events = POLLIN;
+			job[n++] = &par->job[i];
+		}
+		else if (par->job[i].pid > 0
+			&& waitpid(par->job[i].pid, &status, WNOHANG) > 0)
+		{
+			par->job[i].status = exit_code(status);
+			par->job[i].pid = 0;
+			par->running--;
+		}
+		else
+			waiting |= (par->job[i].pid > 0);
+	}
+	if (n && !waiting)
+		waiting = -1;
+	else
+		waiting = 10;
+	if (poll(pfd, n, waiting) <= 0)
+		return ;
+	while (n-- > 0)
+	{
+		if (!pfd[n].revents)
+			continue ;
+		buf_grow(&job[n]->out, 65536);
+		i = read(job[n]->fd, job[n]->out.data + job[n]->out.len, 65536);
+		if (i > 0)
+			job[n]->out.len += i;
+		if (i > 0)
+			continue ;
+		close(job[n]->fd);
+		job[n]->fd = -1;
+	}
+}
+
+static int	run_jobs(t_parallel *par, char **args)
+{
+	int	failed;
+
+	failed = 0;
+	while (par->printed < par->count)
+	{
+		while (par->running < par->jobs && par->launched < par->count)
+		{
+			launch(par, &par->job[par->launched], args[par->launched]);
+			par->launched++;
+		}
+		collect(par);
+		while (par->printed < par->launched && par->job[par->printed].fd < 0
+			&& par->job[par->printed].pid <= 0)
+		{
+			emit(&par->job[par->printed].out);
+			failed += (par->job[par->printed++].status != 0);
+		}
+	}
+	if (failed > 101)
+		failed = 101;
+	return (failed);
+}
+
+// Resolved once for all jobs unless the command itself is templated
+static char	*job_path(char *name)
+{
+	char	**path;
+	char	*found;
+
+	if (strstr(name, "{}"))
+		return (NULL);
+	if (ft_strchr(name, '/'))
+		return (ft_strdup(name));
+	path = get_path(g_shell.env_list);
+	found = check_command_in_path(path, name);
+	if (path)
+		free_2d(path);
+	return (found);
+}
+
+static int	usage_error(void)
+{
+	char	*msg;
+
+	msg = "minishell: parallel: usage: parallel [-j N] cmd [::: args]\n";
+	write(2, msg, ft_strlen(msg));
+	return (2);
+}
+
+// parallel [-j N] CMD [ARG...] [::: INPUT...]
+int	ft_parallel(char **str)
+{
+	t_parallel	par;
+	t_buf		in;
+	char		**args;
+	int			failed;
+
+	memset(&par, 0, sizeof(t_parallel));
+	par.tmpl = str + 1;
+	par.jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	if (str[1] && !ft_strcmp(str[1], "-j") && str[2])
+	{
+		par.jobs = ft_atoi(str[2]);
+		par.tmpl = str + 3;
+	}
+	while (par.tmpl[par.len] && ft_strcmp(par.tmpl[par.len], ":::"))
+		par.len++;
+	if (!par.len)
+		return (usage_error());
+	in.data = NULL;
+	if (par.tmpl[par.len])
+		args = par.tmpl + par.len + 1;
+	else
+		args = stdin_args(&in, &par.count);
+	while (args[par.count])
+		par.count++;
+	if (par.jobs < 1)
+		par.jobs = 1;
+	if (par.jobs > par.count && par.count)
+		par.jobs = par.count;
+	par.job = malloc(sizeof(t_job) * (par.count + 1));
+	memset(par.job, 0, sizeof(t_job) * (par.count + 1));
+	par.path = job_path(par.tmpl[0]);
+	par.envp = create_envp(g_shell.env_list);
+	failed = run_jobs(&par, args);
+	if (in.data)
+		free(args);
+	free(in.data);
+	free(par.job);
+	free(par.path);
+	free_2d(par.envp);
+	return (failed);
+}
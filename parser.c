@@ -12,100 +12,149 @@
 
 #include "minishell.h"
 
-int	to_alloc_count(t_token_list **tokens)
+int	is_redirection(int type)
 {
-	t_token_list	*tokens_;
-	int				i;
+	return (type == RIGHTRED || type == LEFTRED
+		|| type == APPEND || type == HEREDOC);
+}
+
+// NAME= at the start of a word, unquoted and not from a substitution
+int	is_assignment(t_token_list *token)
+{
+	int	i;
 
-	tokens_ = *tokens;
+	if (token->type != WORD || (token->flags & (T_QUOTED | T_SPLIT))
+		|| (token->value[0] >= '0' && token->value[0] <= '9'))
+		return (0);
 	i = 0;
-	while (tokens_ && tokens_->type != PIPE && tokens_->type != NLINE)
+	while (token->value[i] == '_' || ft_isalnum(token->value[i]))
+		i++;
+	return (i > 0 && token->value[i] == '=');
+}
+
+void	append_word(t_args *args, char *value, int glob)
+{
+	char	*pat;
+	char	*tmp;
+
+	if (!args->word)
+		args->word = ft_strdup(value);
+	else
+	{
+		tmp = args->word;
+		args->word = ft_strjoin(tmp, value);
+		free(tmp);
+	}
+	if (glob)
 	{
-		if (tokens_->type == RIGHTRED || tokens_->type == LEFTRED
-			|| tokens_->type == APPEND || tokens_->type == HEREDOC)
+		args->has_glob = 1;
+		pat = ft_strdup(value);
+	}
+	else
+		pat = glob_escape(value);
+	tmp = args->pat;
+	args->pat = ft_strjoin(tmp, pat);
+	free(tmp);
+	free(pat);
+}
+
+// Unquoted substitutions are split into fields on blanks
+void	split_word(t_args *args, char *value)
+{
+	char	*part;
+	int		i;
+
+	while (*value)
+	{
+		i = 0;
+		while (value[i] && !ft_strchr(" \t\n", value[i]))
+			i++;
+		if (i)
 		{
-			tokens_ = tokens_->next;
-			if (tokens_->type == SPACE)
-				tokens_ = tokens_->next;
-			if (tokens_->type == WORD)
-				tokens_ = tokens_->next;
-				
+			part = ft_strndup(value, i);
+			append_word(args, part, 0);
+			free(part);
 		}
-		if (tokens_ && (tokens_->type == SPACE))
-			tokens_ = tokens_->next;
-		if (tokens_ && (tokens_->type == WORD || tokens_->type == DOLLAR))
-		{
-			if (tokens_->type == DOLLAR)
-				tokens_ = tokens_->next;
-			while (tokens_ && (tokens_->type == WORD || tokens_->type == AFDOLLAR))
-				tokens_ = tokens_->next;	
+		if (!value[i])
+			break ;
+		args_flush(args);
+		while (value[i] && ft_strchr(" \t\n", value[i]))
 			i++;
-		}
+		value += i;
+	}
+}
+
+t_token_list	*add_word(t_args *args, t_token_list *tokens)
+{
+	if (tokens->type == DOLLAR && tokens->next->type == AFDOLLAR)
+		tokens = tokens->next;
+	if (!args->word && args->env)
+	{
+		args->assign = is_assignment(tokens);
+		if (!args->assign)
+			args->env = NULL;
 	}
-	return (i);
+	if (args->assign)
+		append_word(args, tokens->value, 0);
+	else if (tokens->flags & T_SPLIT)
+		split_word(args, tokens->value);
+	else
+		append_word(args, tokens->value, tokens->flags & T_GLOB);
+	return (tokens->next);
+}
+
+t_token_list	*add_redirection(t_redirections **redirections, t_token_list *tokens)
+{
+	if (tokens->next->type == WORD)
+	{
+		fill_redirections_list(redirections, init_redirection(tokens->type, tokens->next->value));
+		tokens = tokens->next->next;
+	}
+	else
+	{
+		fill_redirections_list(redirections, init_redirection(tokens->type, tokens->next->next->value));
+		tokens = tokens->next->next->next;
+	}
+	return (tokens);
 }
 
 void *parser(t_cmd_line **cmd_line, t_token_list *tokens)
 {
-    char			**str;
+	t_args			args;
+	t_args			env;
 	t_redirections	*redirections;
-	char			*tmp;
-	int				i;
+	t_cmd_line		*cmd;
+
 	if (!tokens || tokens->type == NLINE)
 		return (NULL);
 	while (tokens)
 	{
-		i = 0;
-		tmp = NULL;
-		str = malloc(sizeof(char *) * (to_alloc_count(&tokens) + 1));
-		str[i + to_alloc_count(&tokens)] = NULL;
+		args_init(&args);
+		args_init(&env);
+		args.env = &env;
 		redirections = NULL;
-		if (tokens && tokens->type == SPACE)
-		{
-			tokens = tokens->next;
-		}
 		while (tokens && tokens->type != PIPE && tokens->type != NLINE)
 		{
-			if (tokens->type == WORD || tokens->type == DOLLAR)
-			{
-				if (tokens->type == DOLLAR && tokens->next->type == AFDOLLAR)
-					tokens = tokens->next;
-				if (!tmp)
-					tmp = tokens->value;
-				else
-					tmp = ft_strjoin(tmp, tokens->value);
-				str[i] = tmp;
-				tokens = tokens->next;
-			}	
-			if (tokens && (tokens->type == RIGHTRED || tokens->type == LEFTRED
-				|| tokens->type == APPEND || tokens->type == HEREDOC))
+			if (tokens->type == WORD || tokens->type == DOLLAR
+				|| tokens->type == AFDOLLAR)
+				tokens = add_word(&args, tokens);
+			else
 			{
-				if (tokens->next->type == WORD)
-				{
-					fill_redirections_list(&redirections, init_redirection(tokens->type, tokens->next->value));
-					tokens = tokens->next->next;
-				}
+				args_flush(&args);
+				if (is_redirection(tokens->type))
+					tokens = add_redirection(&redirections, tokens);
 				else
-				{
-					fill_redirections_list(&redirections, init_redirection(tokens->type, tokens->next->next->value));
-					tokens = tokens->next->next->next;
-				}
-				if (tokens && tokens->type == SPACE)
 					tokens = tokens->next;
 			}
-			if (tokens && tokens->type == SPACE)
-			{
-				if (tokens->next->type != NLINE && tokens->next->type != PIPE)
-					i++;
-				tokens = tokens->next;
-				tmp = NULL;
-			}
 		}
+		args_flush(&args);
 		if (tokens && (tokens->type == NLINE || tokens->type == PIPE))
 		{
-			fill_cmd_line(cmd_line, init_cmdline(str, redirections, tokens));
+			cmd = init_cmdline(args.str, redirections, tokens);
+			cmd->assigns = env.str;
+			fill_cmd_line(cmd_line, cmd);
 			tokens = tokens->next;
 		}
 	}
 	return (NULL);
-}
\ No newline at end of file
+}
@@ -0,0 +1,360 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   parser_list.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/18 11:05:39 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/18 11:05:39 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+t_node	*new_node(int type)
+{
+	t_node	*node;
+
+	node = malloc(sizeof(t_node));
+	memset(node, 0, sizeof(t_node));
+	node->type = type;
+	return (node);
+}
+
+// Reserved words only count unquoted, as a whole word
+int	is_keyword(t_token_list *token, char *word)
+{
+	if (!token || token->type != WORD || (token->flags & T_QUOTED)
+		|| ft_strcmp(token->value, word))
+		return (0);
+	return (!token->next || token->next->type == SPACE
+		|| token->next->type == SEMI || token->next->type == NLINE
+		|| token->next->type == PIPE || token->next->type == PAREN_CLOSE
+		|| is_redirection(token->next->type));
+}
+
+// Where a simple pipeline stops: a separator, the ) of a subshell, or a
+// | in front of a group or loop
+static int	ends_pipeline(t_token_list *token)
+{
+	if (!token || token->type == SEMI || token->type == NLINE
+		|| token->type == PAREN_CLOSE)
+		return (1);
+	if (token->type != PIPE)
+		return (0);
+	token = token->next;
+	while (token && token->type == SPACE)
+		token = token->next;
+	return (is_compound(token));
+}
+
+static int	at_stop(t_token_list *token, char *stop)
+{
+	if (!ft_strcmp(stop, ")"))
+		return (token->type == PAREN_CLOSE);
+	return (is_keyword(token, stop));
+}
+
+void	skip_separators(t_parse *p)
+{
+	while (p->tok && (p->tok->type == SPACE || p->tok->type == SEMI))
+		p->tok = p->tok->next;
+}
+
+// Copies one pipeline, without its surrounding blanks, into a list of
+// its own ending in NLINE, the shape expand() and parser() expect
+t_token_list	*copy_until_separator(t_parse *p)
+{
+	t_token_list	*copy;
+	t_token_list	*last;
+	t_token_list	*node;
+
+	copy = NULL;
+	last = NULL;
+	while (!ends_pipeline(p->tok))
+	{
+		if (p->tok->type != SPACE || !ends_pipeline(p->tok->next))
+		{
+			node = new_token(p->tok->value, p->tok->type);
+			node->flags = p->tok->flags;
+			if (!copy)
+				copy = node;
+			else
+				last->next = node;
+			last = node;
+		}
+		p->tok = p->tok->next;
+	}
+	if (!copy)
+		return (NULL);
+	last->next = new_token("N", NLINE);
+	return (copy);
+}
+
+t_node	*parse_command(t_parse *p)
+{
+	t_node	*node;
+
+	if (is_keyword(p->tok, "time"))
+		return (parse_time(p));
+	node = parse_stage(p);
+	if (node && at_pipe(p))
+		return (parse_pipe(p, node));
+	return (node);
+}
+
+// One command of a pipeline: a loop, a group, a function definition or
+// a simple pipeline up to the next separator
+t_node	*parse_stage(t_parse *p)
+{
+	t_node	*node;
+
+	if (is_keyword(p->tok, "for") || is_keyword(p->tok, "while")
+		|| is_keyword(p->tok, "until"))
+		return (parse_loop(p));
+	if (is_funcdef(p->tok))
+		return (parse_function(p));
+	if (p->tok->type == PAREN_OPEN || is_keyword(p->tok, "{"))
+		return (parse_group(p));
+	if (is_keyword(p->tok, "do") || is_keyword(p->tok, "done")
+		|| is_keyword(p->tok, "}") || p->tok->type == PAREN_CLOSE)
+	{
+		parse_error(p);
+		return (NULL);
+	}
+	node = new_node(N_PIPELINE);
+	node->tokens = copy_until_separator(p);
+	if (!node->tokens || !syntax(node->tokens, &p->err))
+	{
+		parse_error(p);
+		ft_lstclear(&node->tokens);
+		free(node);
+		return (NULL);
+	}
+	return (node);
+}
+
+// Commands up to the end of input or up to the reserved word stop,
+// which is left for the caller to consume
+t_node	*parse_list(t_parse *p, char *stop)
+{
+	t_node	*head;
+	t_node	*last;
+	t_node	*node;
+
+	head = NULL;
+	last = NULL;
+	while (p->state == P_DONE)
+	{
+		skip_separators(p);
+		if (!p->tok || p->tok->type == NLINE)
+		{
+			if (stop)
+				p->state = P_INCOMPLETE;
+			break ;
+		}
+		if (stop && at_stop(p->tok, stop))
+			break ;
+		node = parse_command(p);
+		if (!node)
+			break ;
+		if (!head)
+			head = node;
+		else
+			last->next = node;
+		last = node;
+	}
+	return (head);
+}
+
+// Only the first error of a parse is kept for the caller to report,
+// with the token it was found at
+void	parse_error(t_parse *p)
+{
+	if (!p->err)
+		p->err = "parse error";
+	if (!p->at)
+		p->at = p->tok;
+	p->state = P_ERROR;
+}
+
+static t_token_list	*tail_token(t_token_list *head)
+{
+	t_token_list	*tail;
+
+	tail = head;
+	if (head->last)
+		tail = head->last;
+	while (tail->next)
+		tail = tail->next;
+	return (tail);
+}
+
+// Tokenizes one more line onto the command read so far: the NLINE that
+// ended it turns into the ; the newline stands for, so the list is what
+// tokenizing the joined text would give. Returns the line's first token
+static t_token_list	*pending_add(t_pending *pend, char *line, char **err)
+{
+	t_token_list	*tokens;
+	t_token_list	*tail;
+	t_tools			tools;
+
+	tools.s_quote = 0;
+	tools.d_quote = 0;
+	tokens = tokenizer(line, &tools);
+	*err = tools.err;
+	if (!tokens || tools.err)
+	{
+		ft_lstclear(&tokens);
+		return (NULL);
+	}
+	pend->lines++;
+	if (!pend->tokens)
+	{
+		pend->tokens = tokens;
+		return (tokens);
+	}
+	tail = tail_token(pend->tokens);
+	tail->type = SEMI;
+	tail->value = ";";
+	tail->flags |= T_EOL;
+	tail->next = tokens;
+	pend->tokens->last = tail_token(tokens);
+	return (tokens);
+}
+
+// An incomplete command only completes on a line that can close a loop,
+// group or function
+static int	may_close(t_token_list *tok)
+{
+	while (tok)
+	{
+		if (tok->type == PAREN_CLOSE || (tok->type == WORD
+				&& (!ft_strcmp(tok->value, "done")
+					|| !ft_strcmp(tok->value, "}"))))
+			return (1);
+		tok = tok->next;
+	}
+	return (0);
+}
+
+// Which of the pending lines the parse stopped on, 0 for the first
+static int	line_of(t_token_list *tok, t_token_list *at)
+{
+	int	line;
+
+	line = 0;
+	while (tok && tok != at)
+	{
+		if (tok->flags & T_EOL)
+			line++;
+		tok = tok->next;
+	}
+	return (line);
+}
+
+void	pending_clear(t_pending *pend)
+{
+	ft_lstclear(&pend->tokens);
+	pend->lines = 0;
+}
+
+static t_node	*parse_pending(t_pending *pend, int *state, char **err)
+{
+	t_parse	p;
+	t_node	*tree;
+
+	p.tok = pend->tokens;
+	p.state = P_DONE;
+	p.err = NULL;
+	p.at = NULL;
+	tree = parse_list(&p, NULL);
+	*state = p.state;
+	*err = p.err;
+	if (p.state != P_DONE)
+	{
+		free_tree(tree);
+		tree = NULL;
+	}
+	if (p.state == P_ERROR && !p.at)
+		p.at = p.tok;
+	if (p.state == P_ERROR)
+		pend->err_line = line_of(pend->tokens, p.at);
+	if (p.state != P_INCOMPLETE)
+		pending_clear(pend);
+	return (tree);
+}
+
+// Feeds one line of a command that may span several; the tokens of the
+// earlier lines are kept, so no line is tokenized twice. A lazy pend
+// also skips the parse on lines that cannot complete the command and
+// leaves errors to be found on the one that can, or on the final call
+// with a NULL line at the end of input: each line is then parsed once
+// more only when it may close something. On P_ERROR, err_line is the
+// line the parser stopped on. Nothing is printed and no shell state is
+// touched, so several threads can parse at once
+t_node	*parse_lines(t_pending *pend, char *line, int *state, char **err)
+{
+	t_token_list	*added;
+
+	*state = P_ERROR;
+	pend->err_line = pend->lines;
+	added = NULL;
+	if (line)
+		added = pending_add(pend, line, err);
+	if (line && !added)
+	{
+		pending_clear(pend);
+		return (NULL);
+	}
+	*state = P_INCOMPLETE;
+	*err = NULL;
+	if (line && pend->lazy && pend->lines > 1 && !may_close(added))
+		return (NULL);
+	return (parse_pending(pend, state, err));
+}
+
+// One line on its own; P_INCOMPLETE means a loop is still open and
+// more input is needed
+t_node	*parse_tree(char *line, int *state, char **err)
+{
+	t_pending	pend;
+	t_node		*tree;
+
+	memset(&pend, 0, sizeof(t_pending));
+	tree = parse_lines(&pend, line, state, err);
+	pending_clear(&pend);
+	return (tree);
+}
+
+t_node	*parse_input(char *line, int *state)
+{
+	t_node	*tree;
+	char	*err;
+
+	tree = parse_tree(line, state, &err);
+	if (*state == P_ERROR && err)
+	{
+		write(1, err, ft_strlen(err));
+		write(1, "\n", 1);
+	}
+	return (tree);
+}
+
+void	free_tree(t_node *node)
+{
+	t_node	*next;
+
+	while (node)
+	{
+		next = node->next;
+		ft_lstclear(&node->tokens);
+		ft_lstclear(&node->words);
+		free_tree(node->cond);
+		free_tree(node->body);
+		free(node->var);
+		free(node);
+		node = next;
+	}
+}
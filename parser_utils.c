@@ -42,6 +42,9 @@ void	fill_redirections_list(t_redirections **redirections, t_redirections *new)
 
 void	separator(t_cmd_line *cmd, t_token_list *token)
 {
+	cmd->separator = e_nline;
+	if (!token)
+		return ;
 	if (token->type == NLINE)
 		cmd->separator = e_nline;
 	else if (token->type == PIPE)
@@ -54,6 +57,7 @@ t_cmd_line	*init_cmdline(char **str, t_redirections *redirections, t_token_list
 
 	cmd = malloc(sizeof(t_cmd_line));
 	cmd->str = str;
+	cmd->assigns = NULL;
 	cmd->redirections = redirections;
 	separator(cmd, token);
 	cmd->next = NULL;
@@ -75,4 +79,54 @@ void	fill_cmd_line(t_cmd_line **cmdline, t_cmd_line *new)
 			curr = curr->next;
 		curr->next = new;
 	}
+}
+
+void	args_init(t_args *args)
+{
+	args->cap = 8;
+	args->len = 0;
+	args->str = malloc(sizeof(char *) * args->cap);
+	args->str[0] = NULL;
+	args->word = NULL;
+	args->pat = NULL;
+	args->has_glob = 0;
+	args->assign = 0;
+	args->env = NULL;
+}
+
+// Keeps str NULL-terminated after every push
+void	args_push(t_args *args, char *str)
+{
+	char	**new;
+	int		i;
+
+	if (args->len + 1 >= args->cap)
+	{
+		args->cap *= 2;
+		new = malloc(sizeof(char *) * args->cap);
+		i = -1;
+		while (++i < args->len)
+			new[i] = args->str[i];
+		free(args->str);
+		args->str = new;
+	}
+	args->str[args->len++] = str;
+	args->str[args->len] = NULL;
+}
+
+void	args_flush(t_args *args)
+{
+	if (!args->word)
+		return ;
+	if (args->assign)
+		args_push(args->env, args->word);
+	else if (args->has_glob)
+		glob_expand(args, args->pat, args->word);
+	else
+		args_push(args, args->word);
+	free(args->pat);
+	args->word = NULL;
+	args->pat = NULL;
+	args->has_glob = 0;
+	args->assign = 0;
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   procsub.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/16 16:05:47 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/16 16:05:47 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+static t_procsub	**get_procsubs(void)
+{
+	static t_procsub	*procsubs;
+
+	return (&procsubs);
+}
+
+// Runs cmd concurrently with its stdout (<(cmd)) or stdin (>(cmd)) on a
+// pipe and returns the /dev/fd path of the end the command will use
+char	*procsub_spawn(char *cmd, int type)
+{
+	t_procsub	*new;
+	int			fd[2];
+	char		*num;
+	char		*path;
+
+	if (pipe_cloexec(fd) == -1)
+		return (ft_strdup("/dev/null"));
+	new = malloc(sizeof(t_procsub));
+	new->pid = fork();
+	if (!new->pid)
+	{
+		if (type == PROCSUB_IN)
+			dup2(fd[1], 1);
+		else
+			dup2(fd[0], 0);
+		close(fd[0]);
+		close(fd[1]);
+		g_shell.last_line = 1;
+		body(cmd, NULL, g_shell.export_list, g_shell.env_list);
+		exit(g_shell.status);
+	}
+	new->fd = fd[type == PROCSUB_OUT];
+	close(fd[type == PROCSUB_IN]);
+	// the command opens /dev/fd/N after exec, so this end must survive it
+	fcntl(new->fd, F_SETFD, 0);
+	new->next = *get_procsubs();
+	*get_procsubs() = new;
+	num = ft_itoa(new->fd);
+	path = ft_strjoin("/dev/fd/", num);
+	free(num);
+	return (path);
+}
+
+// Closing our end first lets readers see EOF and writers get SIGPIPE,
+// so waiting for them afterwards cannot block
+void	procsub_cleanup(void)
+{
+	t_procsub	*curr;
+	t_procsub	*next;
+
+	curr = *get_procsubs();
+	while (curr)
+	{
+		close(curr->fd);
+		curr = curr->next;
+	}
+	curr = *get_procsubs();
+	while (curr)
+	{
+		next = curr->next;
+		if (curr->pid > 0)
+			waitpid(curr->pid, NULL, 0);
+		free(curr);
+		curr = next;
+	}
+	*get_procsubs() = NULL;
+}
@@ -38,7 +38,9 @@ t_redirections  *last_outfile(t_cmd_line **cmd_line)
     {
         if (curr->type == RIGHTRED || curr->type == APPEND)
         {
-            fd = open(curr->file, O_CREAT | O_RDWR, 0664);
+            fd = open(curr->file, O_CREAT | O_RDWR | O_CLOEXEC, 0664);
+            if (fd != -1)
+                close(fd);
             if (is_last(&curr->next))
                 return (curr);
         }
@@ -72,12 +74,18 @@ t_redirections  *last_infile(t_cmd_line **cmd_line, int *no_file)
     while (curr)
     {
         if (curr->type == RIGHTRED || curr->type == APPEND)
-            fd = open(curr->file, O_CREAT | O_RDWR, 0664);
+        {
+            fd = open(curr->file, O_CREAT | O_RDWR | O_CLOEXEC, 0664);
+            if (fd != -1)
+                close(fd);
+        }
         if (curr->type == LEFTRED || curr->type == HEREDOC)
         {
             if (curr->type == LEFTRED)
             {
-                fd = open(curr->file, O_RDONLY, 0777);
+                fd = open(curr->file, O_RDONLY | O_CLOEXEC);
+                if (fd != -1)
+                    close(fd);
                 if (fd == -1)
                 {
                     write(2, "minishell: ", 12);
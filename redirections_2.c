@@ -19,9 +19,9 @@ void	dup_outfile(t_redirections *redirection)
 	if (redirection->type == RIGHTRED || redirection->type == APPEND)
 	{
 		if (redirection->type == RIGHTRED)
-			fd = open(redirection->file, O_WRONLY | O_TRUNC, 0664);
+			fd = open(redirection->file, O_WRONLY | O_TRUNC | O_CLOEXEC, 0664);
 		if (redirection->type == APPEND)
-			fd = open(redirection->file, O_WRONLY | O_APPEND, 0664);
+			fd = open(redirection->file, O_WRONLY | O_APPEND | O_CLOEXEC, 0664);
 		dup2(fd, 1);
 		close(fd);
 	}
@@ -34,10 +34,50 @@ void	dup_infile(t_redirections *redirection)
 	if (redirection->type == LEFTRED || redirection->type == HEREDOC)
 	{
 		if (redirection->type == LEFTRED)
-			fd = open(redirection->file, O_RDONLY, 0777);
+			fd = open(redirection->file, O_RDONLY | O_CLOEXEC);
 		else
-			fd = open("heredoc", O_RDONLY, 0777);
+			fd = open("heredoc", O_RDONLY | O_CLOEXEC);
 		dup2(fd, 0);
 		close(fd);
 	}
-}
\ No newline at end of file
+}
+
+// Applies a command's redirections to the shell itself, keeping the
+// old stdin/stdout in saved so pop_redirections() can put them back
+int	push_redirections(t_cmd_line **cmd_line, int saved[2])
+{
+	t_redirections	*l_infile;
+	t_redirections	*l_outfile;
+	int				no_file;
+
+	saved[0] = -1;
+	saved[1] = -1;
+	if (!(*cmd_line)->redirections)
+		return (1);
+	no_file = 1;
+	l_infile = last_infile(cmd_line, &no_file);
+	if (!no_file)
+		return (0);
+	l_outfile = last_outfile(cmd_line);
+	saved[0] = fcntl(0, F_DUPFD_CLOEXEC, 3);
+	saved[1] = fcntl(1, F_DUPFD_CLOEXEC, 3);
+	if (l_outfile)
+		dup_outfile(l_outfile);
+	if (l_infile)
+		dup_infile(l_infile);
+	return (1);
+}
+
+void	pop_redirections(int saved[2])
+{
+	if (saved[0] != -1)
+	{
+		dup2(saved[0], 0);
+		close(saved[0]);
+	}
+	if (saved[1] != -1)
+	{
+		dup2(saved[1], 1);
+		close(saved[1]);
+	}
+}
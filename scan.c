@@ -0,0 +1,163 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   scan.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/24 13:40:12 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/24 13:40:12 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+#if defined(__AVX2__)
+# include <immintrin.h>
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#define S_BLANK 1
+#define S_SPECIAL 2
+
+// Blanks separate words; specials start a token of their own
+static const unsigned char	g_class[256] = {
+	['\t'] = S_BLANK, ['\v'] = S_BLANK, ['\f'] = S_BLANK, ['\r'] = S_BLANK,
+	[' '] = S_BLANK, ['\n'] = S_SPECIAL, ['\''] = S_SPECIAL,
+	['"'] = S_SPECIAL, ['`'] = S_SPECIAL, ['$'] = S_SPECIAL,
+	['|'] = S_SPECIAL, ['<'] = S_SPECIAL, ['>'] = S_SPECIAL,
+	[';'] = S_SPECIAL, ['('] = S_SPECIAL, [')'] = S_SPECIAL,
+};
+
+#if defined(__AVX2__)
+# define SCAN_STEP 32
+
+static uint64_t	eq_mask(__m256i v, char c)
+{
+	return ((uint32_t)_mm256_movemask_epi8(
+		_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c))));
+}
+
+static void	scan_block(char *s, uint64_t *blank, uint64_t *special)
+{
+	__m256i	v;
+
+	v = _mm256_loadu_si256((__m256i *)s);
+	*blank = eq_mask(v, ' ') | eq_mask(v, '\t') | eq_mask(v, '\v')
+		| eq_mask(v, '\f') | eq_mask(v, '\r');
+	*special = eq_mask(v, '\n') | eq_mask(v, '\'') | eq_mask(v, '"')
+		| eq_mask(v, '`') | eq_mask(v, '$') | eq_mask(v, '|')
+		| eq_mask(v, '<') | eq_mask(v, '>') | eq_mask(v, ';')
+		| eq_mask(v, '(') | eq_mask(v, ')');
+}
+#elif defined(__SSE2__)
+# define SCAN_STEP 16
+
+static uint64_t	eq_mask(__m128i v, char c)
+{
+	return ((uint16_t)_mm_movemask_epi8(
+		_mm_cmpeq_epi8(v, _mm_set1_epi8(c))));
+}
+
+static void	scan_block(char *s, uint64_t *blank, uint64_t *special)
+{
+	__m128i	v;
+
+	v = _mm_loadu_si128((__m128i *)s);
+	*blank = eq_mask(v, ' ') | eq_mask(v, '\t') | eq_mask(v, '\v')
+		| eq_mask(v, '\f') | eq_mask(v, '\r');
+	*special = eq_mask(v, '\n') | eq_mask(v, '\'') | eq_mask(v, '"')
+		| eq_mask(v, '`') | eq_mask(v, '$') | eq_mask(v, '|')
+		| eq_mask(v, '<') | eq_mask(v, '>') | eq_mask(v, ';')
+		| eq_mask(v, '(') | eq_mask(v, ')');
+}
+#else
+# define SCAN_STEP 8
+
+static void	scan_block(char *s, uint64_t *blank, uint64_t *special)
+{
+	int	i;
+
+	*blank = 0;
+	*special = 0;
+	i = -1;
+	while (++i < SCAN_STEP)
+	{
+		*blank |= (uint64_t)(g_class[(unsigned char)s[i]] == S_BLANK) << i;
+		*special |= (uint64_t)(g_class[(unsigned char)s[i]] == S_SPECIAL)
+			<< i;
+	}
+}
+#endif
+
+// One pass over the line sets a bit per byte in two bitmaps; the
+// tokenizer then finds the end of a word or of a run of blanks with a
+// count-trailing-zeros instead of rescanning the text
+void	scan_line(t_scan *scan, char *line)
+{
+	size_t		words;
+	size_t		i;
+	uint64_t	b;
+	uint64_t	s;
+
+	scan->line = line;
+	scan->len = ft_strlen(line);
+	words = scan->len / 64 + 1;
+	scan->blank = malloc(sizeof(uint64_t) * words * 2);
+	scan->special = scan->blank + words;
+	memset(scan->blank, 0, sizeof(uint64_t) * words * 2);
+	i = 0;
+	while (i + SCAN_STEP <= scan->len)
+	{
+		scan_block(line + i, &b, &s);
+		scan->blank[i / 64] |= b << (i % 64);
+		scan->special[i / 64] |= s << (i % 64);
+		i += SCAN_STEP;
+	}
+	while (i < scan->len)
+	{
+		scan->blank[i / 64] |= (uint64_t)(g_class[(unsigned char)line[i]]
+				== S_BLANK) << (i % 64);
+		scan->special[i / 64] |= (uint64_t)(g_class[(unsigned char)line[i]]
+				== S_SPECIAL) << (i % 64);
+		i++;
+	}
+	scan->special[i / 64] |= ~(uint64_t)0 << (i % 64);
+}
+
+void	scan_free(t_scan *scan)
+{
+	free(scan->blank);
+	scan->blank = NULL;
+	scan->special = NULL;
+}
+
+// First byte at or after pos that is not a blank
+size_t	scan_skip_blanks(t_scan *scan, size_t pos)
+{
+	uint64_t	bits;
+	size_t		w;
+
+	w = pos / 64;
+	bits = ~scan->blank[w] & (~(uint64_t)0 << (pos % 64));
+	while (!bits)
+		bits = ~scan->blank[++w];
+	return (w * 64 + __builtin_ctzll(bits));
+}
+
+// First blank or special byte at or after pos; the end of the line
+// counts as special
+size_t	scan_word_end(t_scan *scan, size_t pos)
+{
+	uint64_t	bits;
+	size_t		w;
+
+	w = pos / 64;
+	bits = (scan->blank[w] | scan->special[w]) & (~(uint64_t)0 << (pos % 64));
+	while (!bits)
+	{
+		w++;
+		bits = scan->blank[w] | scan->special[w];
+	}
+	return (w * 64 + __builtin_ctzll(bits));
+}
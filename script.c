@@ -0,0 +1,123 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   script.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/08 15:41:02 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/08 15:41:02 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+// "path:line: message" into the script's output buffer
+void	script_error(t_script *s, char *msg)
+{
+	char	*num;
+
+	buf_append(s->out, s->path, ft_strlen(s->path));
+	if (s->line)
+	{
+		num = ft_itoa(s->line);
+		buf_append(s->out, ":", 1);
+		buf_append(s->out, num, ft_strlen(num));
+		free(num);
+	}
+	buf_append(s->out, ": ", 2);
+	buf_append(s->out, msg, ft_strlen(msg));
+	buf_append(s->out, "\n", 1);
+}
+
+// Cuts the next line out of the script in place; NULL at the end
+char	*script_line(t_script *s)
+{
+	char	*line;
+	char	*nl;
+
+	if (s->pos >= s->end)
+		return (NULL);
+	line = s->pos;
+	nl = memchr(line, '\n', s->end - line);
+	if (!nl)
+		nl = s->end;
+	*nl = '\0';
+	s->pos = nl + 1;
+	s->line++;
+	return (line);
+}
+
+// A heredoc's body is read from the script when the command runs, so
+// its lines are skipped up to the delimiter instead of parsed
+void	script_heredocs(t_script *s, t_node *node)
+{
+	t_token_list	*tok;
+	t_token_list	*delim;
+	char			*line;
+
+	while (node)
+	{
+		tok = node->tokens;
+		while (tok)
+		{
+			delim = tok->next;
+			if (tok->type == HEREDOC && delim && delim->type != WORD)
+				delim = delim->next;
+			line = NULL;
+			if (tok->type == HEREDOC && delim)
+				line = script_line(s);
+			while (line && ft_strcmp(line, delim->value))
+				line = script_line(s);
+			tok = tok->next;
+		}
+		script_heredocs(s, node->cond);
+		script_heredocs(s, node->body);
+		node = node->next;
+	}
+}
+
+// Parses the command starting at line the way read_command does: an
+// open loop, group or function takes the next lines until it closes or
+// the script ends. Each line is tokenized once and the parse only
+// re-runs on lines that may close the command, so a long body costs
+// one pass unless most of its lines end a nested loop or group
+t_node	*script_command(t_script *s, char *line, int *state, char **err)
+{
+	t_pending	pend;
+	t_node		*tree;
+	int			first;
+
+	memset(&pend, 0, sizeof(t_pending));
+	pend.lazy = 1;
+	first = s->line;
+	tree = parse_lines(&pend, line, state, err);
+	while (*state == P_INCOMPLETE)
+	{
+		line = script_line(s);
+		tree = parse_lines(&pend, line, state, err);
+		if (!line)
+			break ;
+	}
+	s->err_line = first + pend.err_line;
+	pending_clear(&pend);
+	return (tree);
+}
+
+// The message for a command script_command could not parse, on the
+// line the parser stopped at
+void	script_report(t_script *s, int state, char *err)
+{
+	int	line;
+
+	line = s->line;
+	if (state == P_ERROR)
+		s->line = s->err_line;
+	if (state == P_INCOMPLETE)
+		script_error(s, "unexpected end of file");
+	else if (state == P_ERROR && err)
+		script_error(s, err);
+	else if (state == P_ERROR)
+		script_error(s, "parse error");
+	s->line = line;
+}
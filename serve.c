@@ -0,0 +1,280 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   serve.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/26 11:07:45 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/26 11:07:45 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <poll.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// Frames are a type byte, a 4-byte big-endian length and the payload.
+// A request is any number of C (cwd) and E (NAME=value, or NAME to
+// unset) frames ended by one L (command line) frame. The reply is O and
+// E frames carrying stdout and stderr, then one X frame with the status.
+
+static int	read_full(int fd, char *buf, size_t len)
+{
+	ssize_t	n;
+
+	while (len)
+	{
+		n = read(fd, buf, len);
+		if (n <= 0)
+			return (0);
+		buf += n;
+		len -= n;
+	}
+	return (1);
+}
+
+static int	send_frame(int fd, char type, char *data, uint32_t len)
+{
+	unsigned char	head[5];
+	ssize_t			n;
+
+	head[0] = type;
+	head[1] = len >> 24;
+	head[2] = len >> 16;
+	head[3] = len >> 8;
+	head[4] = len;
+	if (send(fd, head, 5, MSG_NOSIGNAL) != 5)
+		return (0);
+	while (len)
+	{
+		n = send(fd, data, len, MSG_NOSIGNAL);
+		if (n <= 0)
+			return (0);
+		data += n;
+		len -= n;
+	}
+	return (1);
+}
+
+static char	*recv_frame(int fd, char *type)
+{
+	unsigned char	head[5];
+	uint32_t		len;
+	char			*data;
+
+	if (!read_full(fd, (char *)head, 5))
+		return (NULL);
+	*type = head[0];
+	len = (head[1] << 24) | (head[2] << 16) | (head[3] << 8) | head[4];
+	if (len > SERVE_MAX_FRAME)
+		return (NULL);
+	data = malloc(len + 1);
+	if (!read_full(fd, data, len))
+	{
+		free(data);
+		return (NULL);
+	}
+	data[len] = '\0';
+	return (data);
+}
+
+static int	read_request(t_request *req)
+{
+	char	type;
+	char	*data;
+
+	while (1)
+	{
+		data = recv_frame(req->fd, &type);
+		if (!data)
+			return (0);
+		if (type == 'L')
+		{
+			req->line = data;
+			return (1);
+		}
+		if (type == 'C')
+		{
+			free(req->cwd);
+			req->cwd = data;
+		}
+		else if (type == 'E' && req->nenv < SERVE_MAX_ENV)
+			req->env[req->nenv++] = data;
+		else
+			free(data);
+	}
+}
+
+// Other connections' pipes may have been inherited through a fork
+// racing with ours; a worker keeping them would hold their replies open
+static void	close_from(int fd)
+{
+#ifdef SYS_close_range
+	if (syscall(SYS_close_range, fd, ~0U, 0) == 0)
+		return ;
+#endif
+	while (fd < 1024)
+		close(fd++);
+}
+
+// The worker is a fork of the warm server: the delta and the cwd only
+// ever touch its copy of the shell
+static void	run_request(t_request *req, int out[2], int err[2])
+{
+	char	*argv[3];
+	char	*eq;
+	int		i;
+
+	dup2(out[1], 1);
+	dup2(err[1], 2);
+	i = open("/dev/null", O_RDONLY);
+	dup2(i, 0);
+	close_from(3);
+	if (req->cwd && chdir(req->cwd) == -1)
+	{
+		perror("minishell: cd");
+		exit(1);
+	}
+	i = -1;
+	while (++i < req->nenv)
+	{
+		eq = ft_strchr(req->env[i], '=');
+		if (eq)
+			*eq = '\0';
+		if (eq)
+			set_env_var(req->env[i], eq + 1);
+		else
+		{
+			argv[0] = "unset";
+			argv[1] = req->env[i];
+			argv[2] = NULL;
+			do_unset(argv, g_shell.export_list, g_shell.env_list);
+		}
+	}
+	g_shell.last_line = 1;
+	body(req->line, NULL, g_shell.export_list, g_shell.env_list);
+	exit(g_shell.status);
+}
+
+static void	relay(t_request *req, int out, int err)
+{
+	struct pollfd	pfd[2];
+	char			buf[65536];
+	ssize_t			n;
+	int				i;
+
+	pfd[0].fd = out;
+	pfd[1].fd = err;
+	pfd[0].events = POLLIN;
+	pfd[1].events = POLLIN;
+	while (pfd[0].fd >= 0 || pfd[1].fd >= 0)
+	{
+		if (poll(pfd, 2, -1) <= 0)
+			continue ;
+		i = -1;
+		while (++i < 2)
+		{
+			if (pfd[i].fd < 0 || !pfd[i].revents)
+				continue ;
+			n = read(pfd[i].fd, buf, sizeof(buf));
+			if (n > 0)
+				send_frame(req->fd, "OE"[i], buf, n);
+			if (n > 0)
+				continue ;
+			close(pfd[i].fd);
+			pfd[i].fd = -1;
+		}
+	}
+}
+
+// One thread per connection: read the request, fork the worker, relay
+// its output and report how it exited
+static void	*serve_client(void *arg)
+{
+	t_request	*req;
+	int			out[2];
+	int			err[2];
+	pid_t		pid;
+	int			status;
+
+	req = arg;
+	status = 1;
+	if (read_request(req) && pipe_cloexec(out) == 0
+		&& pipe_cloexec(err) == 0)
+	{
+		pid = fork();
+		if (!pid)
+			run_request(req, out, err);
+		close(out[1]);
+		close(err[1]);
+		relay(req, out[0], err[0]);
+		if (pid > 0 && waitpid(pid, &status, 0) > 0)
+			status = exit_code(status);
+	}
+	req->line = ft_itoa(status);
+	send_frame(req->fd, 'X', req->line, ft_strlen(req->line));
+	close(req->fd);
+	while (req->nenv)
+		free(req->env[--req->nenv]);
+	free(req->line);
+	free(req->cwd);
+	free(req);
+	return (NULL);
+}
+
+static int	serve_socket(char *path)
+{
+	struct sockaddr_un	addr;
+	int					fd;
+
+	fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (fd < 0 || ft_strlen(path) >= (int)sizeof(addr.sun_path))
+		return (-1);
+	memcpy(addr.sun_path, path, ft_strlen(path));
+	unlink(path);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1
+		|| listen(fd, 128) == -1)
+	{
+		close(fd);
+		return (-1);
+	}
+	return (fd);
+}
+
+// minishell --serve PATH: the environment is loaded once and every
+// request runs in a fork of this warm process
+void	serve(char *path)
+{
+	t_request	*req;
+	pthread_t	tid;
+	int			fd;
+	int			client;
+
+	fd = serve_socket(path);
+	if (fd < 0)
+	{
+		write(2, "minishell: --serve: ", 20);
+		perror(path);
+		exit(1);
+	}
+	while (1)
+	{
+		client = accept4(fd, NULL, NULL, SOCK_CLOEXEC);
+		if (client < 0)
+			continue ;
+		req = malloc(sizeof(t_request));
+		memset(req, 0, sizeof(t_request));
+		req->fd = client;
+		if (pthread_create(&tid, NULL, serve_client, req) == 0)
+			pthread_detach(tid);
+		else
+			serve_client(req);
+	}
+}
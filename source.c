@@ -0,0 +1,274 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   source.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/08 17:26:50 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/08 17:26:50 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+#include <errno.h>
+
+static t_sourced	**get_sourced(void)
+{
+	static t_sourced	*cache;
+
+	return (&cache);
+}
+
+static int	same_file(t_sourced *f, struct stat *st)
+{
+	return (f->dev == st->st_dev && f->ino == st->st_ino
+		&& f->size == st->st_size && f->mtime.tv_sec == st->st_mtim.tv_sec
+		&& f->mtime.tv_nsec == st->st_mtim.tv_nsec);
+}
+
+static void	free_sourced(t_sourced *f)
+{
+	t_sourced_cmd	*cmd;
+	t_sourced_cmd	*next;
+
+	cmd = f->cmds;
+	while (cmd)
+	{
+		next = cmd->next;
+		free_tree(cmd->tree);
+		free(cmd);
+		cmd = next;
+	}
+	free(f->data);
+	free(f);
+}
+
+// Drops what was cached for an older version of the file; an entry
+// that is still running is only marked stale and run_sourced frees it
+// once its last run returns
+static void	forget(struct stat *st)
+{
+	t_sourced	**link;
+	t_sourced	*f;
+
+	link = get_sourced();
+	while (*link)
+	{
+		f = *link;
+		if (f->dev == st->st_dev && f->ino == st->st_ino)
+		{
+			*link = f->next;
+			if (f->busy)
+				f->stale = 1;
+			else
+				free_sourced(f);
+			return ;
+		}
+		link = &f->next;
+	}
+}
+
+// The heredoc bodies after a command are handed to read_line when it
+// runs, so the line ends script_line cut are put back
+static void	keep_feed(t_script *s, t_sourced_cmd *cmd, char *start)
+{
+	char	*end;
+	char	*p;
+
+	end = s->pos;
+	if (end > s->end)
+		end = s->end;
+	if (start > end)
+		start = end;
+	p = start;
+	while (p < end)
+	{
+		if (!*p)
+			*p = '\n';
+		p++;
+	}
+	cmd->feed = start;
+	cmd->feed_len = end - start;
+}
+
+static int	parse_sourced(t_sourced *f, t_script *s)
+{
+	t_sourced_cmd	**last;
+	t_node			*tree;
+	char			*line;
+	char			*err;
+	int				state;
+
+	last = &f->cmds;
+	line = script_line(s);
+	while (line)
+	{
+		tree = script_command(s, line, &state, &err);
+		script_report(s, state, err);
+		if (state != P_DONE)
+			return (0);
+		if (tree)
+		{
+			*last = malloc(sizeof(t_sourced_cmd));
+			(*last)->tree = tree;
+			(*last)->next = NULL;
+			line = s->pos;
+			script_heredocs(s, tree);
+			keep_feed(s, *last, line);
+			last = &(*last)->next;
+		}
+		line = script_line(s);
+	}
+	return (1);
+}
+
+// The whole file in one buffer: read() may return less than asked, so
+// it loops until st_size bytes are in or the file turns out shorter
+static int	read_all(char *path, int fd, char *data, off_t size)
+{
+	off_t	done;
+	ssize_t	n;
+
+	done = 0;
+	while (done < size)
+	{
+		n = read(fd, data + done, size - done);
+		if (n < 0 && errno == EINTR)
+			continue ;
+		if (n < 0)
+		{
+			write(2, "minishell: ", 11);
+			perror(path);
+			return (0);
+		}
+		if (n == 0)
+		{
+			write(2, "minishell: ", 11);
+			write(2, path, ft_strlen(path));
+			write(2, ": file changed while reading\n", 29);
+			return (0);
+		}
+		done += n;
+	}
+	return (1);
+}
+
+// The file is read whole, then every command is parsed before any of
+// them runs
+static t_sourced	*load(char *path, int fd, struct stat *st)
+{
+	t_sourced	*f;
+	t_script	s;
+	t_buf		errors;
+
+	f = malloc(sizeof(t_sourced));
+	memset(f, 0, sizeof(t_sourced));
+	f->dev = st->st_dev;
+	f->ino = st->st_ino;
+	f->mtime = st->st_mtim;
+	f->size = st->st_size;
+	f->data = malloc(st->st_size + 1);
+	if (!read_all(path, fd, f->data, st->st_size))
+	{
+		free_sourced(f);
+		return (NULL);
+	}
+	memset(&errors, 0, sizeof(t_buf));
+	s.path = path;
+	s.out = &errors;
+	s.line = 0;
+	s.pos = f->data;
+	s.end = f->data + st->st_size;
+	if (!parse_sourced(f, &s))
+	{
+		write(2, "minishell: ", 11);
+		write(2, errors.data, errors.len);
+		free(errors.data);
+		free_sourced(f);
+		return (NULL);
+	}
+	f->next = *get_sourced();
+	*get_sourced() = f;
+	return (f);
+}
+
+// Runs in the shell itself so assignments, cd and functions stay; with
+// arguments they are $1... while it runs
+static void	run_sourced(t_sourced *f, char **argv)
+{
+	t_sourced_cmd	*cmd;
+	char			**params;
+	char			*feed;
+	size_t			len;
+	int				last_line;
+
+	params = g_shell.params;
+	if (argv[2])
+		g_shell.params = argv + 1;
+	last_line = g_shell.last_line;
+	g_shell.last_line = 0;
+	g_shell.status = 0;
+	f->busy++;
+	cmd = f->cmds;
+	while (cmd && !g_shell.breaking && !g_shell.continuing)
+	{
+		feed = cmd->feed;
+		len = cmd->feed_len;
+		input_feed(&feed, &len);
+		run_list(cmd->tree);
+		input_feed(&feed, &len);
+		cmd = cmd->next;
+	}
+	f->busy--;
+	if (!f->busy && f->stale)
+		free_sourced(f);
+	g_shell.last_line = last_line;
+	g_shell.params = params;
+}
+
+// source FILE [ARGS] and . FILE: a file sourced again unchanged, same
+// (dev, inode, mtime, size), runs its cached trees without a read or a
+// parse
+int	ft_source(char **argv)
+{
+	struct stat	st;
+	t_sourced	*f;
+	int			fd;
+
+	if (!argv[1])
+	{
+		write(2, "minishell: source: filename argument required\n", 46);
+		return (2);
+	}
+	f = NULL;
+	if (!stat(argv[1], &st))
+		f = *get_sourced();
+	while (f && !same_file(f, &st))
+		f = f->next;
+	fd = -1;
+	if (!f)
+		fd = open(argv[1], O_RDONLY | O_CLOEXEC);
+	if (fd >= 0 && !fstat(fd, &st) && S_ISDIR(st.st_mode))
+	{
+		close(fd);
+		fd = -1;
+		errno = EISDIR;
+	}
+	if (!f && fd < 0)
+	{
+		write(2, "minishell: ", 11);
+		perror(argv[1]);
+		return (1);
+	}
+	if (!f)
+	{
+		forget(&st);
+		f = load(argv[1], fd, &st);
+		close(fd);
+	}
+	if (!f)
+		return (2);
+	run_sourced(f, argv);
+	return (g_shell.status);
+}
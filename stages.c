@@ -0,0 +1,171 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   stages.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/21 09:48:52 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/21 09:48:52 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <errno.h>
+#include <pthread.h>
+
+typedef struct s_stage
+{
+	pthread_t		tid;
+	int				fd;
+	t_buf			buf;
+	size_t			done;
+	struct s_stage	*next;
+}	t_stage;
+
+static t_stage	**get_stages(void)
+{
+	static t_stage	*stages;
+
+	return (&stages);
+}
+
+// Builtins that only produce output can run inside the shell when they
+// feed a pipe: their output is collected and handed to the pipe
+int	runs_as_stage(t_cmd_line *cmd)
+{
+	int	code;
+
+	if (!cmd || cmd->redirections || !cmd->str[0]
+		|| find_function(cmd->str[0]) || (cmd->assigns && cmd->assigns[0]))
+		return (0);
+	code = builtins(cmd->str[0]);
+	if (code == 3)
+		return (cmd->str[1] == NULL);
+	return (code == 1 || code == 2 || code == 4);
+}
+
+void	capture_stage(char **str, t_buf *buf)
+{
+	t_buf	*saved;
+	int		code;
+
+	saved = g_shell.capture;
+	g_shell.capture = buf;
+	code = builtins(str[0]);
+	if (code == 1)
+		ft_echo(str);
+	else if (code == 2)
+		ft_pwd();
+	else if (code == 3)
+		do_export(str, g_shell.export_list, g_shell.env_list);
+	else
+		print_env(*g_shell.env_list);
+	g_shell.capture = saved;
+}
+
+static int	write_some(t_stage *stage)
+{
+	ssize_t	n;
+
+	while (stage->done < stage->buf.len)
+	{
+		n = write(stage->fd, stage->buf.data + stage->done,
+				stage->buf.len - stage->done);
+		if (n <= 0)
+			return (n < 0 && errno == EAGAIN);
+		stage->done += n;
+	}
+	return (0);
+}
+
+// The reader may quit early: SIGPIPE stays blocked in this thread so
+// the write fails with EPIPE instead of killing the shell. The pipe end
+// is then swapped for /dev/null rather than closed: the reader gets its
+// EOF, but the fd number stays taken until wait_stages closes it, so a
+// later pipe cannot reuse it and be closed by close_stage_fds in a
+// child
+static void	*stage_writer(void *arg)
+{
+	t_stage		*stage;
+	sigset_t	set;
+	int			null;
+
+	stage = arg;
+	sigemptyset(&set);
+	sigaddset(&set, SIGPIPE);
+	pthread_sigmask(SIG_BLOCK, &set, NULL);
+	write_some(stage);
+	null = open("/dev/null", O_RDWR | O_CLOEXEC);
+	if (null >= 0)
+	{
+		dup3(null, stage->fd, O_CLOEXEC);
+		close(null);
+	}
+	return (NULL);
+}
+
+// Whatever fits in the pipe is written right away; a larger output is
+// finished by a thread so the stages after this one can start reading
+void	run_stage(t_cmd_line *cmd, int fd)
+{
+	t_stage	*stage;
+
+	stage = malloc(sizeof(t_stage));
+	memset(stage, 0, sizeof(t_stage));
+	capture_stage(cmd->str, &stage->buf);
+	stage->fd = fcntl(fd, F_DUPFD_CLOEXEC, 3);
+	fcntl(stage->fd, F_SETFL, O_NONBLOCK);
+	if (!write_some(stage))
+	{
+		close(stage->fd);
+		free(stage->buf.data);
+		free(stage);
+		return ;
+	}
+	fcntl(stage->fd, F_SETFL, 0);
+	stage->next = *get_stages();
+	*get_stages() = stage;
+	if (!pthread_create(&stage->tid, NULL, stage_writer, stage))
+		return ;
+	*get_stages() = stage->next;
+	stage_writer(stage);
+	close(stage->fd);
+	free(stage->buf.data);
+	free(stage);
+}
+
+int	stages_pending(void)
+{
+	return (*get_stages() != NULL);
+}
+
+// A child must not hold on to a pipe a writer thread is still filling,
+// or its reader would never see EOF
+void	close_stage_fds(void)
+{
+	t_stage	*stage;
+
+	stage = *get_stages();
+	while (stage)
+	{
+		close(stage->fd);
+		stage = stage->next;
+	}
+}
+
+void	wait_stages(void)
+{
+	t_stage	*stage;
+
+	while (*get_stages())
+	{
+		stage = *get_stages();
+		*get_stages() = stage->next;
+		pthread_join(stage->tid, NULL);
+		close(stage->fd);
+		free(stage->buf.data);
+		free(stage);
+	}
+}
@@ -12,7 +12,7 @@
 
 #include "minishell.h"
 
-int	redirections_syntax(t_token_list **tokens)
+int	redirections_syntax(t_token_list **tokens, char **err)
 {
 	t_token_list	*tokens_;
 
@@ -24,9 +24,10 @@ int	redirections_syntax(t_token_list **tokens)
 		{
 			if (tokens_ && (tokens_->next && tokens_->next->type == SPACE ))
 				tokens_ = tokens_->next;
-			if (tokens_ && (tokens_->next->type == NLINE || tokens_->next->type != WORD))
+			if (tokens_ && (tokens_->next->type == NLINE || (tokens_->next->type != WORD
+				&& tokens_->next->type != PROCSUB_IN && tokens_->next->type != PROCSUB_OUT)))
 			{
-				write(1, "parse error\n", ft_strlen("parse error\n"));
+				*err = "parse error";
 				return (0);
 			}
 		}
@@ -35,7 +36,7 @@ int	redirections_syntax(t_token_list **tokens)
 	return (1);
 }
 
-int	pipe_syntax(t_token_list **tokens)
+int	pipe_syntax(t_token_list **tokens, char **err)
 {
 	t_token_list *tokens_;
 
@@ -46,9 +47,10 @@ int	pipe_syntax(t_token_list **tokens)
 		{
 			if (tokens_->next && tokens_->next->type == SPACE)
 				tokens_ = tokens_->next;
-			if (tokens_->next->type == NLINE || tokens_->next->type == PIPE)
+			if (tokens_->next->type == NLINE || tokens_->next->type == PIPE
+				|| tokens_->next->type == SEMI)
 			{
-				write(1, "parse error\n", ft_strlen("parse error\n"));
+				*err = "parse error";
 				return (0);
 			}
 		}
@@ -57,7 +59,7 @@ int	pipe_syntax(t_token_list **tokens)
 	return (1);
 }
 
-int	heredoc_syntax(t_token_list **tokens)
+int	heredoc_syntax(t_token_list **tokens, char **err)
 {
 	t_token_list	*token;
 
@@ -71,7 +73,7 @@ int	heredoc_syntax(t_token_list **tokens)
 				token = token->next;
 			if (token && token->type != DOLLAR && token->type != WORD)
 			{
-				write(1, "parse error\n", ft_strlen("parse error\n"));
+				*err = "parse error";
 				return (0);
 			}
 		}
@@ -80,11 +82,30 @@ int	heredoc_syntax(t_token_list **tokens)
 	return (1);
 }
 
-int	syntax(t_token_list *tokens)
+int	paren_syntax(t_token_list **tokens, char **err)
+{
+	t_token_list	*token;
+
+	token = *tokens;
+	while (token && token->type != NLINE)
+	{
+		if (token->type == PAREN_OPEN || token->type == PAREN_CLOSE)
+		{
+			*err = "parse error";
+			return (0);
+		}
+		token = token->next;
+	}
+	return (1);
+}
+
+int	syntax(t_token_list *tokens, char **err)
 {
 	if (!tokens || tokens->type == NLINE)
 		return (0);
-	if (redirections_syntax(&tokens) && pipe_syntax(&tokens)/*&& heredoc_syntax(&tokens)*/)
+	if (!paren_syntax(&tokens, err))
+		return (0);
+	if (redirections_syntax(&tokens, err) && pipe_syntax(&tokens, err)/*&& heredoc_syntax(&tokens, err)*/)
 		return (1);
 	return (0);
 }
\ No newline at end of file
@@ -12,25 +12,15 @@
 
 #include "minishell.h"
 
-char	*still_dquote(t_token_list **tokens, char *line, t_tools *tools)
+static int	is_expansion(char *line)
 {
-	int	i;
-
-	if (!line)
-		return (NULL);
-	i = 0;
-	if (*line == '$')
-	{
-		line = is_dollar_pipe(tokens, line);
-		line = afdollar(tokens, line);
-	}
-	while (line[i] && line[i] != '\"')
-		i++;
-	addback(tokens, ft_strndup(line, i), WORD);
-	line = line + i;
-	if (line && *line == 34 && tools->dollar_in == 1)
-		line = line + 1;
-	return (line);
+	if (*line == '`')
+		return (1);
+	if (*line != '$')
+		return (0);
+	return (*(line + 1) == '(' || *(line + 1) == '$'
+		|| *(line + 1) == '?' || *(line + 1) == '#' || *(line + 1) == '@'
+		|| ft_isalnum(*(line + 1)));
 }
 
 char	*ft_dquotes(t_token_list **tokens, char *line, t_tools *tools)
@@ -38,19 +28,21 @@ char	*ft_dquotes(t_token_list **tokens, char *line, t_tools *tools)
 	if (!line)
 		return (NULL);
 	tools->d_quote = 0;
-	tools->dollar_in = 0;
-	line = is_dquote(tokens, line, tools);
-	while (!ft_strncmp(line, "$$", 2))
+	line++;
+	while (*line && *line != '\"' && !tools->paren)
 	{
-		line = is_dollar_pipe(tokens, line);
-		line = still_dquote(tokens, line, tools);
-	}
-	if (line && *line == '$')
-	{
-		line = is_dollar_pipe(tokens, line);
-		line = afdollar(tokens, line);
-		line = still_dquote(tokens, line, tools);
+		if (*line == '$' && *(line + 1) == '(')
+			line = is_cmdsub(tokens, line, tools);
+		else if (*line == '`')
+			line = is_backtick(tokens, line, tools);
+		else if (is_expansion(line))
+			line = is_dollar_pipe(tokens, line);
+		else
+			line = is_dquote(tokens, line);
 	}
+	if (*line == '\"')
+		return (line + 1);
+	tools->d_quote = 1;
 	return (line);
 }
 
@@ -63,9 +55,9 @@ char	*ft_squotes(t_token_list **tokens, char *line, t_tools *tools)
 	return (line);
 }
 
-void	open_quote_error(t_token_list **tokens)
+void	open_quote_error(t_token_list **tokens, t_tools *tools)
 {
-	write(1, "Open quote\n", ft_strlen("Open quote\n"));
+	tools->err = "Open quote";
 	ft_lstclear(tokens);
 }
 
@@ -74,6 +66,10 @@ t_token_list *tokenizer(char *line, t_tools *tools)
 	t_token_list	*tokens;
 
 	tokens = NULL;
+	tools->paren = 0;
+	tools->err = NULL;
+	if (line)
+		scan_line(&tools->scan, line);
     while (line && *line)
     {
         if (ft_strchr("\'", *line))
@@ -81,32 +77,77 @@ t_token_list *tokenizer(char *line, t_tools *tools)
 			line = ft_squotes(&tokens, line, tools);
 			if (tools->s_quote == 1)
 			{
-				open_quote_error(&tokens);
+				open_quote_error(&tokens, tools);
 				break ;
 			}
 		}
 		else if (ft_strchr("\"", *line))
 		{
 			line = ft_dquotes(&tokens, line, tools);
+			if (tools->paren == 1)
+			{
+				open_paren_error(&tokens, tools);
+				break ;
+			}
 			if (tools->d_quote == 1)
 			{
-				open_quote_error(&tokens);
+				open_quote_error(&tokens, tools);
 				break ;
 			}
 		}
         else if (ft_strchr(" \t\v\f\r", *line))
-            line = is_wspace(&tokens, line);
+            line = is_wspace(&tokens, line, tools);
+        else if (*line == ';' || *line == '\n')
+        {
+            addback(&tokens, ";", SEMI);
+            line++;
+        }
+        else if (*line == '(' || *line == ')')
+        {
+            if (*line == '(')
+                addback(&tokens, "(", PAREN_OPEN);
+            else
+                addback(&tokens, ")", PAREN_CLOSE);
+            line++;
+        }
+        else if (ft_strchr("><", *line) && *(line + 1) == '(')
+		{
+			line = is_procsub(&tokens, line, tools);
+			if (tools->paren == 1)
+			{
+				open_paren_error(&tokens, tools);
+				break ;
+			}
+		}
         else if (ft_strchr("><", *line))
 		{
             line = is_redirections(&tokens, line, tools);
 			
 		}
 			
+        else if ((*line == '$' && *(line + 1) == '(') || *line == '`')
+		{
+			if (*line == '`')
+				line = is_backtick(&tokens, line, tools);
+			else
+				line = is_cmdsub(&tokens, line, tools);
+			if (tools->paren == 1)
+			{
+				open_paren_error(&tokens, tools);
+				break ;
+			}
+			mark_last_token(&tokens, T_SPLIT);
+		}
         else if (ft_strchr("$|", *line))
+		{
             line = is_dollar_pipe(&tokens, line);
+			if (*(line - 1) == '@' && *(line - 2) == '$')
+				mark_last_token(&tokens, T_SPLIT);
+		}
         else
-            line = is_word(&tokens, line);
+            line = is_word(&tokens, line, tools);
     }
 	addback(&tokens, "N", NLINE);
+	scan_free(&tools->scan);
 	return(tokens);
 }
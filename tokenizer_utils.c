@@ -21,35 +21,29 @@ char    *is_squote(t_token_list **tokens, char *line, t_tools *tools)
     i = 1;
 	while (line[i] && line[i] != '\'')
 		i++;
-    if (line[i] && line[i] == '\'')
+    if (line[i] && line[i] == '\'' && i > 1)
+    {
 	    addback(tokens, ft_strndup(line + 1, i - 1), WORD);
-    else
+        mark_last_token(tokens, T_QUOTED);
+    }
+    else if (line[i] != '\'')
         tools->s_quote = 1;
 	return (line + i + 1);
 }
 
-char	*is_dquote(t_token_list **tokens, char *line, t_tools *tools)
+// Literal text inside double quotes, up to the next expansion or quote
+char	*is_dquote(t_token_list **tokens, char *line)
 {
 	int i;
 
     if (!line)
         return (NULL);
     i = 1;
-	while (line[i] && line[i] != '\"' && line[i] != '$')
+	while (line[i] && line[i] != '\"' && line[i] != '$' && line[i] != '`')
 		i++;
-    if (i == 1 && line[0] == 34 && line[1] != 34)
-        tools->dollar_in = 1;
-	if (line[i] == '$')
-    {
-        tools->dollar_in = 1;
-	    addback(tokens, ft_strndup(line + 1, i - 1), WORD);
-		return (line + i);
-    }
-    if (line[i] && line[i] == '\"')
-	    addback(tokens, ft_strndup(line + 1, i - 1), WORD);
-    else
-        tools->d_quote = 1;
-	return (line + i + 1);
+	addback(tokens, ft_strndup(line, i), WORD);
+	mark_last_token(tokens, T_QUOTED);
+	return (line + i);
 }
 
 char	*no_expand(t_token_list **tokens, char	*line, t_tools *tools)
@@ -45,14 +45,14 @@ char    *is_redirections(t_token_list **tokens, char *line, t_tools *tools)
         if (*(line + 1) == '<')
         {
             addback(tokens, "<<", HEREDOC);
-            line = is_wspace(tokens, line + 2);
+            line = is_wspace(tokens, line + 2, tools);
             while (*line == 34)
             {
                 tools->no_expand = 0;
                 line = no_expand(tokens, line, tools);
                 if (tools->no_expand == 1)
                 {
-                    open_quote_error(tokens);
+                    open_quote_error(tokens, tools);
                     return (NULL);
                 }
             }
@@ -68,17 +68,26 @@ char    *is_redirections(t_token_list **tokens, char *line, t_tools *tools)
 	return (line + 1);
 }
 
-char    *is_wspace(t_token_list **tokens, char *line)
+void    mark_last_token(t_token_list **tokens, int flag)
+{
+    t_token_list    *curr;
+
+    curr = *tokens;
+    if (curr && curr->last)
+        curr = curr->last;
+    while (curr && curr->next)
+        curr = curr->next;
+    if (curr)
+        curr->flags |= flag;
+}
+
+char    *is_wspace(t_token_list **tokens, char *line, t_tools *tools)
 {
-    int i;
-    
     if (!line)
         return (NULL);
-    i = 0;
-    while (ft_strchr(" \t\v\f\r", line[i]) && line[i])
-        i++;
     addback(tokens, " ", SPACE);
-    return (line + i);
+    return (tools->scan.line
+        + scan_skip_blanks(&tools->scan, line - tools->scan.line));
 }
 
 char    *is_dollar_pipe(t_token_list **tokens, char *line)
@@ -104,27 +113,19 @@ char    *is_dollar_pipe(t_token_list **tokens, char *line)
 	return (0);
 }
 
-char    *is_word(t_token_list **tokens, char *line)
+char    *is_word(t_token_list **tokens, char *line, t_tools *tools)
 {
     int		i;
+    char    *word;
 
     if (!line)
         return (NULL);
-    char    *word;
-
-    i = 0;
-    while (!ft_strchr(" \t\v\f\r><|$\'\"", line[i]))
-        i++;
-	word = malloc(i + 1);
-	i = 0;
-	while (!ft_strchr(" \t\v\f\r><|$\'\"", line[i]))
-	{
-		
-		word[i] = line[i];
-		i++;
-	}
-	word[i] = '\0';
+    i = scan_word_end(&tools->scan, line - tools->scan.line)
+        - (line - tools->scan.line);
+	word = ft_strndup(line, i);
 	addback(tokens, word, WORD);
+	if (has_glob_chars(word))
+		mark_last_token(tokens, T_GLOB);
 	return (line + i);
 }
 
@@ -145,6 +146,10 @@ char	*afdollar(t_token_list **tokens, char *line)
 		else
 			break;
 	}
+	if (i == 0 && (line[0] == '?' || line[0] == '#' || line[0] == '@'))
+		i = 1;
+	if (i > 1 && line[0] >= '0' && line[0] <= '9')
+		i = 1;
 	afdollar = malloc(i + 1);
 	while (j < i)
 	{
@@ -6,8 +6,102 @@
 /*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2023/04/04 18:05:59 by mazaroua          #+#    #+#             */
-/*   Updated: 2023/04/04 18:06:10 by mazaroua         ###   ########.fr       */
+/*   Updated: 2023/04/16 15:40:02 by mazaroua         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
-#include "minishell.h"
\ No newline at end of file
+#include "minishell.h"
+
+// Index of the ')' closing the '(' at line[0], skipping quoted text and
+// nested pairs; -1 when it is never closed
+int	match_paren(char *line)
+{
+	int		i;
+	int		depth;
+	char	quote;
+
+	i = 0;
+	depth = 0;
+	quote = 0;
+	while (line[i])
+	{
+		if (quote && line[i] == quote)
+			quote = 0;
+		else if (!quote && (line[i] == '\'' || line[i] == '\"'))
+			quote = line[i];
+		else if (!quote && line[i] == '(')
+			depth++;
+		else if (!quote && line[i] == ')' && --depth == 0)
+			return (i);
+		i++;
+	}
+	return (-1);
+}
+
+char	*is_procsub(t_token_list **tokens, char *line, t_tools *tools)
+{
+	int	end;
+
+	end = match_paren(line + 1);
+	if (end == -1)
+	{
+		tools->paren = 1;
+		return (line + ft_strlen(line));
+	}
+	if (*line == '<')
+		addback(tokens, ft_strndup(line + 2, end - 1), PROCSUB_IN);
+	else
+		addback(tokens, ft_strndup(line + 2, end - 1), PROCSUB_OUT);
+	return (line + end + 2);
+}
+
+// $(cmd), or $((expr)) when the body is itself one parenthesised
+// group; an empty body is kept as " " so the token is never dropped
+char	*is_cmdsub(t_token_list **tokens, char *line, t_tools *tools)
+{
+	int	end;
+
+	end = match_paren(line + 1);
+	if (end == -1)
+	{
+		tools->paren = 1;
+		return (line + ft_strlen(line));
+	}
+	if (*(line + 2) == '(' && end > 2 && *(line + end) == ')')
+	{
+		if (end == 3)
+			addback(tokens, ft_strdup("0"), ARITH);
+		else
+			addback(tokens, ft_strndup(line + 3, end - 3), ARITH);
+	}
+	else if (end == 1)
+		addback(tokens, ft_strdup(" "), CMDSUB);
+	else
+		addback(tokens, ft_strndup(line + 2, end - 1), CMDSUB);
+	return (line + end + 2);
+}
+
+char	*is_backtick(t_token_list **tokens, char *line, t_tools *tools)
+{
+	int	end;
+
+	end = 1;
+	while (line[end] && line[end] != '`')
+		end++;
+	if (!line[end])
+	{
+		tools->paren = 1;
+		return (line + end);
+	}
+	if (end == 1)
+		addback(tokens, ft_strdup(" "), CMDSUB);
+	else
+		addback(tokens, ft_strndup(line + 1, end - 1), CMDSUB);
+	return (line + end + 1);
+}
+
+void	open_paren_error(t_token_list **tokens, t_tools *tools)
+{
+	tools->err = "Open parenthesis";
+	ft_lstclear(tokens);
+}
@@ -0,0 +1,135 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   trace.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/25 16:52:09 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/25 16:52:09 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "minishell.h"
+
+// MINISHELL_TRACE=file writes Chrome trace events (chrome://tracing,
+// ui.perfetto.dev). Every process appends whole events to the same
+// O_APPEND file, so children forked from the shell can add their own.
+static t_trace	*get_trace(void)
+{
+	static t_trace	trace = {-1, 0, NULL};
+
+	return (&trace);
+}
+
+void	trace_init(void)
+{
+	t_trace	*trace;
+	char	*path;
+
+	path = getenv("MINISHELL_TRACE");
+	if (!path || !*path)
+		return ;
+	trace = get_trace();
+	trace->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND
+			| O_CLOEXEC, 0644);
+	trace->pid = getpid();
+	if (trace->fd >= 0)
+		write(trace->fd, "[\n", 2);
+}
+
+long	trace_now(void)
+{
+	struct timespec	ts;
+
+	if (get_trace()->fd < 0)
+		return (0);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000L + ts.tv_nsec / 1000);
+}
+
+static void	put_json(t_buf *buf, char *s)
+{
+	char	esc[8];
+
+	while (s && *s)
+	{
+		if (*s == '"' || *s == '\\' || (unsigned char)*s < 0x20)
+		{
+			snprintf(esc, sizeof(esc), "\\u%04x", (unsigned char)*s);
+			buf_append(buf, esc, 6);
+		}
+		else
+			buf_append(buf, s, 1);
+		s++;
+	}
+}
+
+// One event, one write: appends from several processes never interleave
+static void	emit(char *name, char ph, long ts, long dur, int tid)
+{
+	t_buf	buf;
+	char	tail[128];
+	int		len;
+
+	memset(&buf, 0, sizeof(t_buf));
+	buf_append(&buf, "{\"name\":\"", 9);
+	put_json(&buf, name);
+	len = snprintf(tail, sizeof(tail), "\",\"ph\":\"%c\",\"ts\":%ld,"
+			"\"dur\":%ld,\"pid\":%d,\"tid\":%d},\n", ph, ts, dur,
+			get_trace()->pid, tid);
+	buf_append(&buf, tail, len);
+	write(get_trace()->fd, buf.data, buf.len);
+	free(buf.data);
+}
+
+// A complete span on the calling process' track, from start to now
+void	trace_span(char *name, long start)
+{
+	if (get_trace()->fd < 0)
+		return ;
+	emit(name, 'X', start, trace_now() - start, getpid());
+}
+
+void	trace_instant(char *name)
+{
+	if (get_trace()->fd < 0)
+		return ;
+	emit(name, 'i', trace_now(), 0, getpid());
+}
+
+// A forked child is drawn on its own track, from the fork to the
+// moment its parent reaps it
+void	trace_fork(pid_t pid, char *name, long start)
+{
+	t_trace_child	*child;
+
+	if (get_trace()->fd < 0 || pid <= 0)
+		return ;
+	trace_span("fork", start);
+	child = malloc(sizeof(t_trace_child));
+	child->pid = pid;
+	child->start = start;
+	child->name = ft_strdup(name);
+	child->next = get_trace()->children;
+	get_trace()->children = child;
+}
+
+void	trace_reap(pid_t pid)
+{
+	t_trace_child	**link;
+	t_trace_child	*child;
+
+	if (get_trace()->fd < 0)
+		return ;
+	link = &get_trace()->children;
+	while (*link && (*link)->pid != pid)
+		link = &(*link)->next;
+	if (!*link)
+		return ;
+	child = *link;
+	*link = child->next;
+	emit(child->name, 'X', child->start, trace_now() - child->start, pid);
+	free(child->name);
+	free(child);
+}
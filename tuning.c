@@ -0,0 +1,203 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   tuning.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: mazaroua <mazaroua@student.42.fr>          +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2023/04/07 16:02:11 by mazaroua          #+#    #+#             */
+/*   Updated: 2023/04/07 16:02:11 by mazaroua         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "minishell.h"
+#include <sched.h>
+
+static t_tuning	*get_tuning(void)
+{
+	static t_tuning	tuning;
+
+	return (&tuning);
+}
+
+// Options are plain shell variables, looked up again for every pipeline
+static char	*shell_var(char *name)
+{
+	t_env_list	*env;
+
+	if (!g_shell.env_list)
+		return (NULL);
+	env = *g_shell.env_list;
+	while (env && ft_strcmp(env->name, name))
+		env = env->next;
+	if (!env || !env->value || !*env->value)
+		return (NULL);
+	return (env->value);
+}
+
+static int	read_int(char *path, int def)
+{
+	char	buf[32];
+	ssize_t	n;
+	int		fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return (def);
+	n = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (n <= 0)
+		return (def);
+	buf[n] = '\0';
+	return (ft_atoi(buf));
+}
+
+// MINISHELL_PIPESIZE=max or a byte count; counts above
+// /proc/sys/fs/pipe-max-size are cut down to it
+static int	pipe_size(void)
+{
+	char	*value;
+	int		max;
+	int		size;
+
+	value = shell_var("MINISHELL_PIPESIZE");
+	if (!value)
+		return (0);
+	max = read_int("/proc/sys/fs/pipe-max-size", 1048576);
+	if (!ft_strcmp(value, "max"))
+		return (max);
+	size = ft_atoi(value);
+	if (size > max)
+		return (max);
+	return (size);
+}
+
+static int	pin_policy(void)
+{
+	char	*value;
+
+	value = shell_var("MINISHELL_PIN");
+	if (value && !ft_strcmp(value, "siblings"))
+		return (PIN_SIBLINGS);
+	if (value && !ft_strcmp(value, "cores"))
+		return (PIN_CORES);
+	return (PIN_OFF);
+}
+
+static void	read_place(t_cpu_place *p, int cpu)
+{
+	char	path[128];
+
+	p->cpu = cpu;
+	snprintf(path, sizeof(path),
+		"/sys/devices/system/cpu/cpu%d/topology/physical_package_id", cpu);
+	p->package = read_int(path, 0);
+	snprintf(path, sizeof(path),
+		"/sys/devices/system/cpu/cpu%d/topology/core_id", cpu);
+	p->core = read_int(path, cpu);
+	p->thread = 0;
+}
+
+// siblings: package, core, thread - a stage and the next one share a
+// physical core and its caches. cores: package, thread, core - they
+// get a core each but stay on one socket while it has cores left
+static int	before(t_cpu_place *a, t_cpu_place *b, int policy)
+{
+	if (a->package != b->package)
+		return (a->package < b->package);
+	if (policy == PIN_CORES && a->thread != b->thread)
+		return (a->thread < b->thread);
+	if (a->core != b->core)
+		return (a->core < b->core);
+	if (a->thread != b->thread)
+		return (a->thread < b->thread);
+	return (a->cpu < b->cpu);
+}
+
+static void	sort_places(t_cpu_place *places, int n, int policy)
+{
+	t_cpu_place	tmp;
+	int			i;
+	int			j;
+
+	i = 0;
+	while (++i < n)
+	{
+		tmp = places[i];
+		j = i;
+		while (j > 0 && before(&tmp, &places[j - 1], policy))
+		{
+			places[j] = places[j - 1];
+			j--;
+		}
+		places[j] = tmp;
+	}
+}
+
+// The CPUs the shell may run on, in the order stages take them; read
+// from /sys once per policy
+static void	build_order(t_tuning *t, int policy)
+{
+	cpu_set_t	set;
+	int			cpu;
+	int			i;
+
+	t->ncpus = 0;
+	t->policy = policy;
+	if (sched_getaffinity(0, sizeof(set), &set))
+		return ;
+	cpu = -1;
+	while (++cpu < CPU_SETSIZE && t->ncpus < TUNE_MAX_CPUS)
+		if (CPU_ISSET(cpu, &set))
+			read_place(&t->places[t->ncpus++], cpu);
+	i = -1;
+	while (++i < t->ncpus)
+	{
+		cpu = -1;
+		while (++cpu < i)
+			if (t->places[cpu].package == t->places[i].package
+				&& t->places[cpu].core == t->places[i].core)
+				t->places[i].thread++;
+	}
+	sort_places(t->places, t->ncpus, policy);
+}
+
+// Reads the options once per pipeline, before its pipes are made
+void	tune_pipeline(void)
+{
+	t_tuning	*t;
+	int			policy;
+
+	t = get_tuning();
+	t->pipe_size = pipe_size();
+	policy = pin_policy();
+	t->pin = policy;
+	if (policy != PIN_OFF && policy != t->policy)
+		build_order(t, policy);
+}
+
+// Bigger pipes mean fewer wakeups between a fast producer and its
+// consumer; the kernel may refuse (per-user pipe quota), which leaves
+// the default size
+void	tune_pipe(int fd[2])
+{
+#ifdef F_SETPIPE_SZ
+	if (get_tuning()->pipe_size > 0)
+		fcntl(fd[1], F_SETPIPE_SZ, get_tuning()->pipe_size);
+#endif
+}
+
+// In the child of stage i, before redirections and exec
+void	tune_stage(int i)
+{
+	t_tuning	*t;
+	cpu_set_t	set;
+
+	t = get_tuning();
+	if (t->pin == PIN_OFF || t->ncpus < 2)
+		return ;
+	CPU_ZERO(&set);
+	CPU_SET(t->places[i % t->ncpus].cpu, &set);
+	sched_setaffinity(0, sizeof(set), &set);
+}
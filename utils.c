@@ -43,11 +43,10 @@ int ft_strlen(char *str)
 
 void	ft_putstr(char	*str)
 {
-	int	i;
-
-	i = 0;
-	while (str[i])
-		write(1, &str[i++], 1);
+	if (g_shell.capture)
+		buf_append(g_shell.capture, str, ft_strlen(str));
+	else
+		write(1, str, ft_strlen(str));
 }
 
 char	*ft_strjoin(char *s1, char *s2)
@@ -94,56 +93,6 @@ void	ft_lstclear(t_token_list	**lst)
 	*lst = NULL;
 }
 
-int count(char *line)
-{
-    int i;
-    int j;
-    int c;
-
-    i = 0;
-    j = ft_strlen(line) - 1;
-    c = 0;
-    while (line[i] && line[i] == 32)
-        i++;
-    while (line[j] && line[j] == 32)
-    {
-        j--;
-        c++;
-    }
-    return (c + i);
-}
-
-int all_spaces(char *line, int i)
-{
-    while (line[i])
-    {
-        if (line[i] != 32)
-            return (0);
-        i++;
-    }
-    return (1);
-}
-
-char    *skip_wspaces(char *line)
-{
-    int     i;
-    int     j;
-    char    *new;
-    
-    i = 0;
-    j = 0;
-	if (!line)
-		return (NULL);
-    new = malloc(ft_strlen(line) - count(line) + 1);
-    while (line[i] && line[i] == 32)
-        i++;
-    while (line[i] && !all_spaces(line, i))
-        new[j++] = line[i++];
-    free(line);
-    new[j] = '\0';
-    return (new);
-}
-
 int	inside_quotes(char *line, int i)
 {
 	int	tmp;
@@ -197,7 +146,9 @@ t_token_list *new_token(char *value, int type)
     new = malloc(sizeof(t_token_list));
     new->type = type;
     new->value = value;
+    new->flags = 0;
     new->next = NULL;
+    new->last = NULL;
     return (new);
 }
 
@@ -209,13 +160,18 @@ void    addback(t_token_list **tokens, char *value, int type)
 	if (!value || !*value)
 		return ;
     if (!*tokens)
-        *tokens = new_token(value, type);
-    else
     {
-        while (curr->next)
-            curr = curr->next;
-        curr->next = new_token(value, type);
+        *tokens = new_token(value, type);
+        (*tokens)->last = *tokens;
+        return ;
     }
+    // the head remembers the tail so building a list stays linear
+    if (curr->last)
+        curr = curr->last;
+    while (curr->next)
+        curr = curr->next;
+    curr->next = new_token(value, type);
+    (*tokens)->last = curr->next;
 }
 
 void	free_2d(char **str)
@@ -275,6 +231,25 @@ char	*ft_itoa(int n)
 	return (str);
 }
 
+int	ft_atoi(char *str)
+{
+	int	i;
+	int	sign;
+	int	n;
+
+	i = 0;
+	while (str[i] == ' ' || (str[i] >= 9 && str[i] <= 13))
+		i++;
+	sign = 1;
+	if (str[i] == '-' || str[i] == '+')
+		if (str[i++] == '-')
+			sign = -1;
+	n = 0;
+	while (str[i] >= '0' && str[i] <= '9')
+		n = n * 10 + (str[i++] - '0');
+	return (n * sign);
+}
+
 char	*ft_strdup(char *src)
 {
 	int		i;